@@ -0,0 +1,131 @@
+#include <AxisPredictor.h>
+#include <MemoryReport.h>
+#include <math.h>
+
+AxisPredictor::AxisPredictor()
+    : position_(0),
+      velocity_(0),
+      alpha_(PREDICTOR_DEFAULT_ALPHA),
+      beta_(PREDICTOR_DEFAULT_BETA),
+      limit_(PREDICTOR_DEFAULT_LIMIT),
+      seeded_(false)
+{
+}
+
+static uint32_t toQ32(float value)
+{
+    if (value <= 0.0f)
+    {
+        return 0;
+    }
+    if (value >= 1.0f)
+    {
+        return 0xFFFFFFFFu;
+    }
+    return static_cast<uint32_t>(value * 4294967296.0f);
+}
+
+void AxisPredictor::setTheta(float theta)
+{
+    setGains(toQ32(1.0f - theta * theta), toQ32((1.0f - theta) * (1.0f - theta)));
+}
+
+void AxisPredictor::setGains(uint32_t alphaQ32, uint32_t betaQ32)
+{
+    alpha_ = alphaQ32;
+    beta_ = betaQ32;
+}
+
+// Alpha-beta pozicio zaj / meresi zaj (varianciak aranya, allandosult allapot)
+static float alphaBetaNoiseRatio(float theta)
+{
+    float alpha = 1.0f - theta * theta;
+    float beta = (1.0f - theta) * (1.0f - theta);
+    return (2.0f * alpha * alpha + 2.0f * beta - 3.0f * alpha * beta) / (alpha * (4.0f - 2.0f * alpha - beta));
+}
+
+void AxisPredictor::matchEmaNoise(uint8_t emaShift)
+{
+    // EMA: a / (2 - a), theta szerint monoton, felezessel keressuk (csak beallitaskor fut)
+    float a = 1.0f / static_cast<float>(1UL << emaShift);
+    float target = a / (2.0f - a);
+    float low = 0.0f;
+    float high = 0.99999f;
+    for (uint8_t i = 0; i < 32; ++i)
+    {
+        float mid = 0.5f * (low + high);
+        if (alphaBetaNoiseRatio(mid) > target)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    setTheta(high);
+}
+
+void RAM_FUNC("predictor") AxisPredictor::updateQ16(uint32_t sampleQ16)
+{
+    int64_t measured = static_cast<int64_t>(sampleQ16) << 16;
+    if (!seeded_)
+    {
+        position_ = measured;
+        velocity_ = 0;
+        seeded_ = true;
+        return;
+    }
+
+    // Elorejelzes, majd korrekcio a maradekkal (Q16-ban, hogy a szorzat ferjen 64 bitbe)
+    int64_t predicted = position_ + velocity_;
+    int32_t residual = static_cast<int32_t>((measured - predicted) >> 16);
+    position_ = predicted + ((static_cast<int64_t>(residual) * alpha_) >> 16);
+    velocity_ += (static_cast<int64_t>(residual) * beta_) >> 16;
+
+    // Korlat: lemaradasnal huzzuk a mintaval, tullovesnel (forduloban) a sebesseg nullazodik
+    int64_t limit = static_cast<int64_t>(limit_) << 32;
+    int64_t error = position_ - measured;
+    if (error > limit)
+    {
+        position_ = measured + limit;
+        if (velocity_ > 0)
+        {
+            velocity_ = 0;
+        }
+    }
+    else if (error < -limit)
+    {
+        position_ = measured - limit;
+        if (velocity_ < 0)
+        {
+            velocity_ = 0;
+        }
+    }
+}
+
+uint32_t AxisPredictor::predict(uint32_t leadQ8) const
+{
+    if (leadQ8 > PREDICTOR_MAX_LEAD_Q8)
+    {
+        leadQ8 = PREDICTOR_MAX_LEAD_Q8;
+    }
+    // Az extrapolacio sem mehet a korlatnal messzebb
+    int64_t lead = (velocity_ >> 8) * static_cast<int64_t>(leadQ8);
+    int64_t limit = static_cast<int64_t>(limit_) << 32;
+    if (lead > limit)
+    {
+        lead = limit;
+    }
+    else if (lead < -limit)
+    {
+        lead = -limit;
+    }
+
+    int64_t value = (position_ + lead + (1LL << 15)) >> 16;
+    if (value < 0)
+    {
+        return 0;
+    }
+    return value > (1023L << 16) ? (1023UL << 16) : static_cast<uint32_t>(value);
+}
@@ -0,0 +1,62 @@
+#ifndef AXISPREDICTOR_H
+#define AXISPREDICTOR_H
+
+#include <stdint.h>
+
+const uint16_t PREDICTOR_DEFAULT_LIMIT = 8;    // kovetesi hiba korlat ADC countban
+const uint16_t PREDICTOR_MAX_LEAD_Q8 = 0xFFFF; // legfeljebb ~255 minta elore
+// Alapertelmezett erositesek (Q32): nyugalomban ugyanannyi zaj, mint az 1/256 EMA-nal
+const uint32_t PREDICTOR_DEFAULT_ALPHA = 13435414; // 0.003128
+const uint32_t PREDICTOR_DEFAULT_BETA = 10524;     // 2.45e-6
+
+//
+// AxisPredictor Class
+// Fixed-point alpha-beta tracker for one axis. Estimates position and
+// velocity per sample and extrapolates the position to a later time (the
+// expected USB poll), so the host sees less lag than the smoothing adds.
+// The estimate is kept within a few counts of the latest sample: when it
+// falls behind a fast move it is pulled along, and when it overshoots a
+// reversal the velocity is dropped.
+//
+class AxisPredictor {
+public:
+  AxisPredictor();
+
+  // Kritikusan csillapitott eset: alpha = 1 - theta^2, beta = (1 - theta)^2
+  void setTheta(float theta);
+
+  // Olyan theta, amellyel nyugalmi helyzetben a zaj megegyezik egy 1/2^shift EMA-eval
+  void matchEmaNoise(uint8_t emaShift);
+
+  // Erositesek Q32-ben (1.0 = 2^32)
+  void setGains(uint32_t alphaQ32, uint32_t betaQ32);
+  uint32_t getAlpha() const { return alpha_; }
+  uint32_t getBeta() const { return beta_; }
+
+  // Kovetesi hiba es extrapolacio korlat ADC countban
+  void setLimit(uint16_t counts) { limit_ = counts; }
+
+  void reset() { seeded_ = false; }
+
+  // Uj minta (10 bit)
+  void update(uint16_t sample) { updateQ16(static_cast<uint32_t>(sample) << 16); }
+  // Uj minta Q10.16-ban: a CIC, az igazitas es a korrekcio tort bitjei is szamitanak
+  void updateQ16(uint32_t sampleQ16);
+
+  // Becsult pozicio leadQ8 / 256 mintanyi idovel a legutolso minta utan, Q10.16
+  uint32_t predict(uint32_t leadQ8) const;
+
+  // Becsles Q32-ben: pozicio countban, sebesseg count/mintaban
+  int64_t position() const { return position_; }
+  int64_t velocity() const { return velocity_; }
+
+private:
+  int64_t position_;
+  int64_t velocity_;
+  uint32_t alpha_;
+  uint32_t beta_;
+  uint16_t limit_;
+  bool seeded_;
+};
+
+#endif // AXISPREDICTOR_H
@@ -0,0 +1,30 @@
+#ifndef AXISROUTES_H
+#define AXISROUTES_H
+
+#include <AxisRouting.h>
+#include <PicoGamepad.h>
+
+// Egyetlen gamepad: a korabbi SetX/SetY/... hivasokkal azonos kiosztas
+constexpr AxisRoute HID_AXIS_ROUTES[] = {
+    {CHANNEL_HAND_WHEEL, AXIS_FILTER_PREDICTED, 0, X_AXIS_LSB},
+    {CHANNEL_RUDDER, AXIS_FILTER_PREDICTED, 0, Y_AXIS_LSB},
+    {CHANNEL_THROTTLE_LEFT, AXIS_FILTER_PREDICTED, 0, Rx_AXIS_LSB},
+    {CHANNEL_THROTTLE_RIGHT, AXIS_FILTER_PREDICTED, 0, Ry_AXIS_LSB},
+    {CHANNEL_BRAKE_LEFT, AXIS_FILTER_PREDICTED, 0, SLIDER_AXIS_LSB},
+    {CHANNEL_BRAKE_RIGHT, AXIS_FILTER_PREDICTED, 0, DIAL_AXIS_LSB},
+};
+
+// Composite: 0 = pedalok (X rudder, Y bal fek, Z jobb fek), 1 = gaz (X bal, Y jobb), 2 = kormany (X)
+constexpr AxisRoute COMPOSITE_AXIS_ROUTES[] = {
+    {CHANNEL_RUDDER, AXIS_FILTER_PREDICTED, 0, 0},
+    {CHANNEL_BRAKE_LEFT, AXIS_FILTER_PREDICTED, 0, 1},
+    {CHANNEL_BRAKE_RIGHT, AXIS_FILTER_PREDICTED, 0, 2},
+    {CHANNEL_THROTTLE_LEFT, AXIS_FILTER_PREDICTED, 1, 0},
+    {CHANNEL_THROTTLE_RIGHT, AXIS_FILTER_PREDICTED, 1, 1},
+    {CHANNEL_HAND_WHEEL, AXIS_FILTER_PREDICTED, 2, 0},
+};
+
+typedef AxisRouter<HID_AXIS_ROUTES, routeCount(HID_AXIS_ROUTES)> HidAxisRouter;
+typedef AxisRouter<COMPOSITE_AXIS_ROUTES, routeCount(COMPOSITE_AXIS_ROUTES)> CompositeAxisRouter;
+
+#endif // AXISROUTES_H
@@ -0,0 +1,73 @@
+#ifndef AXISROUTING_H
+#define AXISROUTING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <MCP3008Reader.h>
+
+// Szuro a map-oles elott
+enum AxisFilter : uint8_t
+{
+  AXIS_FILTER_EMA,       // mindig az EMA
+  AXIS_FILTER_PREDICTED  // prediktor, ha a csatornan be van kapcsolva ('A'), kulonben EMA
+};
+
+// Egy tengely utja: csatorna -> szuro -> map-oles (aktiv profil) -> report hely
+struct AxisRoute
+{
+  uint8_t channel; // MCP3008 csatorna
+  AxisFilter filter;
+  uint8_t target;  // eszkoz index (composite), egyebkent 0
+  uint8_t slot;    // report bajt offset (PicoGamepad) vagy tengely index (VirtualGamepad)
+};
+
+// PicoGamepad: a tengely kozvetlenul a bemeneti tombbe (X_AXIS_LSB ...), little-endian
+struct ReportAxisSink
+{
+  uint8_t *inputs;
+
+  template <uint8_t TARGET, uint8_t SLOT>
+  inline void write(int16_t value)
+  {
+    inputs[SLOT] = static_cast<uint16_t>(value) & 0xFF;
+    inputs[SLOT + 1] = static_cast<uint16_t>(value) >> 8;
+  }
+};
+
+//
+// AxisRouter
+// Expands a constexpr route table at compile time into one straight-line
+// function: each route becomes an inlined read of its channel, the chosen
+// filter, the mapping and a store to a fixed report location. No loop, no
+// table lookups and no bounds or isActive checks at run time; channels
+// without a route generate no code at all. The sink decides where a value
+// goes (raw report bytes, or a VirtualGamepad axis).
+//
+template <const AxisRoute *ROUTES, size_t COUNT>
+struct AxisRouter
+{
+  template <typename Sink>
+  static inline void apply(MCP3008Reader &reader, Sink &sink)
+  {
+    apply(reader, sink, std::make_index_sequence<COUNT>());
+  }
+
+private:
+  template <typename Sink, size_t... I>
+  static inline void apply(MCP3008Reader &reader, Sink &sink, std::index_sequence<I...>)
+  {
+    // C++14: a pack kifejtese tomb inicializalassal, sorrendben
+    using expand = int[];
+    (void)expand{0, (sink.template write<ROUTES[I].target, ROUTES[I].slot>(
+                         reader.template mappedValue<ROUTES[I].channel,
+                                                     ROUTES[I].filter == AXIS_FILTER_PREDICTED>()),
+                     0)...};
+  }
+};
+
+// Tabla merete forditasi idoben
+template <size_t N>
+constexpr size_t routeCount(const AxisRoute (&)[N]) { return N; }
+
+#endif // AXISROUTING_H
@@ -0,0 +1,426 @@
+#include <Benchmark.h>
+#include <RunningMedian.h>
+#include <AxisPredictor.h>
+#include <MappingProfile.h>
+#include <CicDecimator.h>
+#include <Oversample.h>
+#include <AxisRoutes.h>
+#include <string.h>
+#include <algorithm>
+#include <stdio.h>
+
+static const uint16_t BENCH_SAMPLES = 4096;
+
+// Determinisztikus teszt jel: lassu rampa zajjal es idonkenti tuskekkel
+static uint16_t benchSignal(uint16_t i, uint32_t &lfsr)
+{
+    lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+    uint16_t value = 300 + (i & 0x1FF) + (lfsr & 0x7);
+    if ((lfsr & 0x3F) == 0)
+    {
+        value = (lfsr & 1) ? 1023 : 0;
+    }
+    return value;
+}
+
+void printBenchmarkResult(Print &out, const char *name, uint32_t value, const char *unit)
+{
+#ifdef ARDUINO_ARCH_SIM
+    // A szimulator ora csak ADC, I2C, USB es delay alatt lep: a tiszta CPU ido (ns/...) ott
+    // mindig 0 lenne, nem eredmeny
+    if (strncmp(unit, "ns/", 3) == 0)
+    {
+        return;
+    }
+#endif
+    out.print("#BENCH,");
+    out.print(name);
+    out.print(',');
+    out.print(value);
+    out.print(',');
+    out.println(unit);
+}
+
+// Naiv median: az ablak masolasa es rendezese minden mintanal
+static uint16_t naiveMedian(const uint16_t *window, uint8_t count)
+{
+    uint16_t sorted[MEDIAN_MAX_WINDOW];
+    std::copy(window, window + count, sorted);
+    std::sort(sorted, sorted + count);
+    return sorted[(count - 1) / 2];
+}
+
+void runMedianBenchmark(Print &out)
+{
+    static RunningMedian median;
+    static const uint8_t windows[] = {5, 9, 21, MEDIAN_MAX_WINDOW};
+
+    for (uint8_t w : windows)
+    {
+        median.setWindow(w);
+        uint32_t lfsr = 0xACE1u;
+        uint32_t checksumFast = 0;
+        uint32_t start = micros();
+        for (uint16_t i = 0; i < BENCH_SAMPLES; ++i)
+        {
+            checksumFast += median(benchSignal(i, lfsr));
+        }
+        uint32_t fastUs = micros() - start;
+
+        uint16_t ring[MEDIAN_MAX_WINDOW];
+        uint8_t count = 0;
+        uint8_t head = 0;
+        uint32_t checksumNaive = 0;
+        lfsr = 0xACE1u;
+        start = micros();
+        for (uint16_t i = 0; i < BENCH_SAMPLES; ++i)
+        {
+            ring[head] = benchSignal(i, lfsr);
+            head = (head + 1) % w;
+            if (count < w)
+            {
+                count++;
+            }
+            checksumNaive += naiveMedian(ring, count);
+        }
+        uint32_t naiveUs = micros() - start;
+
+        char name[32];
+        snprintf(name, sizeof(name), "median_running_w%u", w);
+        printBenchmarkResult(out, name, fastUs * 1000UL / BENCH_SAMPLES, "ns/sample");
+        snprintf(name, sizeof(name), "median_sort_w%u", w);
+        printBenchmarkResult(out, name, naiveUs * 1000UL / BENCH_SAMPLES, "ns/sample");
+        snprintf(name, sizeof(name), "median_match_w%u", w);
+        printBenchmarkResult(out, name, checksumFast == checksumNaive, "bool");
+    }
+}
+
+// A regi EMA: egesz allapot 2^8-szoros skalaval, a visszacsatolas csonkolt
+static inline void emaIntUpdate(uint32_t &state, uint16_t value)
+{
+    state += value - (state >> 8);
+}
+
+// Q10.16 allapot, mint az MCP3008Reader-ben
+static inline void emaQ16Update(uint32_t &state, uint16_t value)
+{
+    state += static_cast<int32_t>((static_cast<uint32_t>(value) << 16) - state) >> 8;
+}
+
+void runPredictorBenchmark(Print &out)
+{
+    // Csak ido; a kesest es a zajt az EMA-hoz kepest a test/test_predictor ellenorzi
+    static AxisPredictor predictor;
+    predictor.reset();
+    volatile uint32_t sink = 0;
+    uint32_t lfsr = 0xACE1u;
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < BENCH_SAMPLES; ++i)
+    {
+        predictor.update(benchSignal(i, lfsr));
+    }
+    uint32_t updateUs = micros() - start;
+
+    start = micros();
+    for (uint16_t i = 0; i < BENCH_SAMPLES; ++i)
+    {
+        sink = predictor.predict(i);
+    }
+    uint32_t predictUs = micros() - start;
+    (void)sink;
+
+    printBenchmarkResult(out, "predictor_update", updateUs * 1000UL / BENCH_SAMPLES, "ns/sample");
+    printBenchmarkResult(out, "predictor_predict", predictUs * 1000UL / BENCH_SAMPLES, "ns/call");
+}
+
+// Kulonbozo kimeneti ertekek es a legnagyobb ugras egy lassu rampan (bal gaz: 360..631)
+static void mappingSteps(bool fractional, uint32_t &distinct, uint32_t &maxStep)
+{
+    static MappingTable table;
+    MappingProfile profile = {};
+    profile.channels[0].minValue = 360;
+    profile.channels[0].maxValue = 631;
+    profile.channels[0].flags = PROFILE_FLAG_ACTIVE;
+    ProfileManager::buildTable(profile, table);
+
+    uint32_t intState = 350U << 8;
+    uint32_t q16State = 350U << 16;
+    int32_t previous = table.channels[0].apply(350U << 16);
+    distinct = 1;
+    maxStep = 0;
+    // 1 count / 64 minta, 350-tol 640-ig
+    for (uint32_t i = 0; i < 290U * 64; ++i)
+    {
+        uint16_t value = 350 + i / 64;
+        emaIntUpdate(intState, value);
+        emaQ16Update(q16State, value);
+        uint32_t filtered = fractional ? q16State : ((intState + 128) >> 8) << 16;
+        int32_t mapped = table.channels[0].apply(filtered);
+        if (mapped != previous)
+        {
+            uint32_t step = mapped > previous ? mapped - previous : previous - mapped;
+            maxStep = step > maxStep ? step : maxStep;
+            distinct++;
+            previous = mapped;
+        }
+    }
+}
+
+void runFilterBenchmark(Print &out)
+{
+    // Ido: 8 csatorna, mint egy frame
+    static uint32_t states[8];
+    volatile uint32_t sink = 0;
+    uint32_t lfsr = 0xACE1u;
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < BENCH_SAMPLES; ++i)
+    {
+        uint16_t value = benchSignal(i, lfsr);
+        for (uint8_t ch = 0; ch < 8; ++ch)
+        {
+            emaIntUpdate(states[ch], value);
+        }
+    }
+    uint32_t intUs = micros() - start;
+    sink = states[0];
+
+    lfsr = 0xACE1u;
+    start = micros();
+    for (uint16_t i = 0; i < BENCH_SAMPLES; ++i)
+    {
+        uint16_t value = benchSignal(i, lfsr);
+        for (uint8_t ch = 0; ch < 8; ++ch)
+        {
+            emaQ16Update(states[ch], value);
+        }
+    }
+    uint32_t q16Us = micros() - start;
+    sink = states[0];
+    (void)sink;
+
+    // Beallas 600-rol 512-re: az egesz allapot egy count kozelebe ragad
+    uint32_t intState = 600U << 8;
+    uint32_t q16State = 600U << 16;
+    for (uint16_t i = 0; i < 8192; ++i)
+    {
+        emaIntUpdate(intState, 512);
+        emaQ16Update(q16State, 512);
+    }
+    uint32_t intError = ((intState - (512U << 8)) * 1000UL) >> 8;
+    uint32_t q16Error = (static_cast<uint64_t>(q16State - (512U << 16)) * 1000UL) >> 16;
+
+    uint32_t intSteps, intMaxStep, q16Steps, q16MaxStep;
+    mappingSteps(false, intSteps, intMaxStep);
+    mappingSteps(true, q16Steps, q16MaxStep);
+
+    printBenchmarkResult(out, "ema_int", intUs * 1000UL / (BENCH_SAMPLES * 8UL), "ns/sample");
+    printBenchmarkResult(out, "ema_q16", q16Us * 1000UL / (BENCH_SAMPLES * 8UL), "ns/sample");
+    printBenchmarkResult(out, "ema_settle_error_int", intError, "mcount");
+    printBenchmarkResult(out, "ema_settle_error_q16", q16Error, "mcount");
+    printBenchmarkResult(out, "map_distinct_int", intSteps, "values");
+    printBenchmarkResult(out, "map_distinct_q16", q16Steps, "values");
+    printBenchmarkResult(out, "map_max_step_int", intMaxStep, "hid");
+    printBenchmarkResult(out, "map_max_step_q16", q16MaxStep, "hid");
+}
+
+// CIC teszt: 3 fokozat, 4-szeres decimalas, mint a pico_cic build
+static const uint8_t CIC_BENCH_STAGES = 3;
+static const uint8_t CIC_BENCH_RATE_LOG2 = 2;
+
+// Oversample::readDecimated ugyanazon a bemeneten: 2^rateLog2 minta osszege, Q10.16-ra normalizalva
+struct BoxcarDecimator
+{
+    uint32_t sum = 0;
+    uint8_t phase = 0;
+    uint32_t value = 0;
+
+    inline bool push(uint16_t sample)
+    {
+        sum += sample;
+        if (++phase < (1U << CIC_BENCH_RATE_LOG2))
+        {
+            return false;
+        }
+        value = sum << (16 - CIC_BENCH_RATE_LOG2);
+        sum = 0;
+        phase = 0;
+        return true;
+    }
+    uint32_t output() const { return value; }
+};
+
+void runCicBenchmark(Print &out, Adafruit_MCP3008 *adc)
+{
+    // Ido: 8 csatorna bemeneti mintankent, mint egy frame (az atvitelt, az alias elnyomast es
+    // a zajt a test/test_cic ellenorzi)
+    static CicDecimator channels[8];
+    for (CicDecimator &channel : channels)
+    {
+        channel.configure(CIC_BENCH_STAGES, CIC_BENCH_RATE_LOG2, true);
+    }
+    BoxcarDecimator boxcars[8];
+    volatile uint32_t sink = 0;
+    uint32_t lfsr = 0xACE1u;
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < BENCH_SAMPLES; ++i)
+    {
+        uint16_t value = benchSignal(i, lfsr);
+        for (uint8_t ch = 0; ch < 8; ++ch)
+        {
+            channels[ch].push(value);
+        }
+    }
+    uint32_t cicUs = micros() - start;
+    sink = channels[0].output();
+
+    lfsr = 0xACE1u;
+    start = micros();
+    for (uint16_t i = 0; i < BENCH_SAMPLES; ++i)
+    {
+        uint16_t value = benchSignal(i, lfsr);
+        for (uint8_t ch = 0; ch < 8; ++ch)
+        {
+            boxcars[ch].push(value);
+        }
+    }
+    uint32_t boxcarUs = micros() - start;
+    sink = boxcars[0].output();
+    (void)sink;
+    printBenchmarkResult(out, "cic_push", cicUs * 1000UL / (BENCH_SAMPLES * 8UL), "ns/sample");
+    printBenchmarkResult(out, "cic_boxcar_push", boxcarUs * 1000UL / (BENCH_SAMPLES * 8UL), "ns/sample");
+
+    if (!adc)
+    {
+        return;
+    }
+    // Valodi ADC-vel, a nem hasznalt 7-es csatornan: 4 minta / kimenet mindket esetben
+    static const uint16_t ADC_OUTPUTS = 256;
+    Oversample oversample(adc, 7, 10 + CIC_BENCH_RATE_LOG2 / 2);
+    start = micros();
+    for (uint16_t i = 0; i < ADC_OUTPUTS; ++i)
+    {
+        sink = oversample.readDecimated();
+    }
+    uint32_t oversampleUs = micros() - start;
+
+    CicDecimator cicComp;
+    cicComp.configure(CIC_BENCH_STAGES, CIC_BENCH_RATE_LOG2, true);
+    start = micros();
+    for (uint16_t i = 0; i < ADC_OUTPUTS; ++i)
+    {
+        while (!cicComp.push(adc->readADC(7)))
+        {
+        }
+        sink = cicComp.output();
+    }
+    uint32_t cicAdcUs = micros() - start;
+    printBenchmarkResult(out, "cic_oversample_read", oversampleUs / ADC_OUTPUTS, "us/output");
+    printBenchmarkResult(out, "cic_adc_read", cicAdcUs / ADC_OUTPUTS, "us/output");
+}
+
+static const uint16_t ROUTING_FRAMES = 256;
+
+// A regi reportTaskFn: egy hivas tengelyenkent, futasideju csatorna ellenorzessel
+// (az egyezest a test/test_axis_routing ellenorzi)
+static void handWiredReport(MCP3008Reader &reader, uint8_t *inputs)
+{
+    static const struct
+    {
+        uint8_t channel;
+        uint8_t offset;
+    } wiring[] = {
+        {CHANNEL_HAND_WHEEL, X_AXIS_LSB},     // SetX
+        {CHANNEL_RUDDER, Y_AXIS_LSB},         // SetY
+        {CHANNEL_THROTTLE_LEFT, Rx_AXIS_LSB}, // SetRx
+        {CHANNEL_THROTTLE_RIGHT, Ry_AXIS_LSB}, // SetRy
+        {CHANNEL_BRAKE_LEFT, SLIDER_AXIS_LSB}, // SetSlider
+        {CHANNEL_BRAKE_RIGHT, DIAL_AXIS_LSB}, // SetDial
+    };
+    for (const auto &axis : wiring)
+    {
+        uint16_t value = reader.getMappedJoystickValue(axis.channel);
+        inputs[axis.offset] = LSB(value);
+        inputs[axis.offset + 1] = MSB(value);
+    }
+}
+
+void runRoutingBenchmark(Print &out, MCP3008Reader &reader)
+{
+    uint8_t expected[DIAL_AXIS_MSB + 1];
+    uint8_t routed[DIAL_AXIS_MSB + 1];
+    uint32_t handUs = 0;
+    uint32_t routedUs = 0;
+    volatile uint8_t checksum = 0; // a kiirt reportok ne optimalizalodjanak ki
+
+    // Profil tablaval es nelkule (linearis map-oles a channelMinMaxValues_ szerint)
+    for (uint8_t pass = 0; pass < 2; ++pass)
+    {
+        const MappingTable *mapping = reader.getMapping();
+        if (pass == 1)
+        {
+            reader.setMapping(nullptr);
+        }
+        for (uint16_t frame = 0; frame < ROUTING_FRAMES; ++frame)
+        {
+            reader.readChannelsWithEMA();
+
+            uint32_t start = micros();
+            handWiredReport(reader, expected);
+            handUs += micros() - start;
+
+            ReportAxisSink sink = {routed};
+            start = micros();
+            HidAxisRouter::apply(reader, sink);
+            routedUs += micros() - start;
+            checksum = expected[DIAL_AXIS_MSB] ^ routed[DIAL_AXIS_MSB];
+        }
+        reader.setMapping(mapping);
+    }
+
+    (void)checksum;
+    const uint32_t frames = 2UL * ROUTING_FRAMES;
+    printBenchmarkResult(out, "routing_hand_wired", handUs * 1000UL / frames, "ns/frame");
+    printBenchmarkResult(out, "routing_routed", routedUs * 1000UL / frames, "ns/frame");
+}
+
+static const uint32_t ALIGN_DEFAULT_READ_US = 30;  // csatornankent, ha nincs mert frame
+
+void runAlignmentBenchmark(Print &out, MCP3008Reader *reader)
+{
+    // Valodi csatornankenti olvasasi ido az utolso frame idobelyegeibol: igazitas nelkul az
+    // utolso csatorna (CHANNEL_COUNT - 1)-szer ennyit kesik (a maradek elterest a
+    // test/test_alignment ellenorzi)
+    uint32_t readUs = ALIGN_DEFAULT_READ_US;
+    if (reader)
+    {
+        reader->readChannelsWithEMA();
+        uint32_t last = 0;
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+        {
+            uint32_t offset = reader->getSampleUs(ch) - reader->getFrameUs();
+            last = offset > last ? offset : last;
+        }
+        if (last > 0)
+        {
+            readUs = (last + (CHANNEL_COUNT - 1) / 2) / (CHANNEL_COUNT - 1);
+        }
+    }
+    printBenchmarkResult(out, "align_read", readUs, "us/channel");
+    printBenchmarkResult(out, "align_raw_skew", readUs * (CHANNEL_COUNT - 1), "us");
+}
+
+void runBenchmarks(Print &out, Adafruit_MCP3008 *adc, MCP3008Reader *reader)
+{
+#ifdef ARDUINO_ARCH_SIM
+    printBenchmarkResult(out, "sim_cpu_timing", 0, "skipped");
+#endif
+    runMedianBenchmark(out);
+    runPredictorBenchmark(out);
+    runFilterBenchmark(out);
+    runCicBenchmark(out, adc);
+    if (reader)
+    {
+        runRoutingBenchmark(out, *reader);
+    }
+    runAlignmentBenchmark(out, reader);
+}
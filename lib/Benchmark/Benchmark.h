@@ -0,0 +1,44 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <Arduino.h>
+#include <Adafruit_MCP3008.h>
+#include <MCP3008Reader.h>
+
+//
+// On-target microbenchmarks
+// Build with -D BENCHMARK (see [env:pico_bench]) and send 'B' over Serial.
+// Every result is printed as a "#BENCH,<name>,<value>,<unit>" line so the
+// host side can collect them; the run blocks the scheduler while it lasts.
+// The simulator charges no CPU time, so there the pure-CPU timings (ns/...)
+// are left out and only the accuracy checks and I/O-bound timings remain.
+//
+
+// Egy eredmeny sor kiirasa
+void printBenchmarkResult(Print &out, const char *name, uint32_t value, const char *unit);
+
+// RunningMedian vs. a regi "masold ki es rendezd" median, mintankenti ido
+void runMedianBenchmark(Print &out);
+
+// AxisPredictor update() es predict() ideje
+void runPredictorBenchmark(Print &out);
+
+// Egesz (Q8 allapot) vs. Q10.16 EMA: ido, beallasi hiba, kimeneti lepcsok a map-olas utan
+void runFilterBenchmark(Print &out);
+
+// CIC decimator vs. Oversample-stilusu osszegzes (boxcar): ido mintankent; adc megadasaval
+// a valodi Oversample::readDecimated is
+void runCicBenchmark(Print &out, Adafruit_MCP3008 *adc);
+
+// AxisRouter vs. a korabbi kezzel irt SetX/SetY/... kiosztas: ido frame-enkent (az egyezest
+// a test/test_axis_routing ellenorzi); a reader valodi frame-eket olvas kozben
+void runRoutingBenchmark(Print &out, MCP3008Reader &reader);
+
+// Frame igazitas: a csatornankenti olvasasi ido a reader utolso frame-jebol es az ebbol
+// adodo csatornak kozotti idoelteres igazitas nelkul
+void runAlignmentBenchmark(Print &out, MCP3008Reader *reader);
+
+// Az osszes benchmark futtatasa
+void runBenchmarks(Print &out, Adafruit_MCP3008 *adc = nullptr, MCP3008Reader *reader = nullptr);
+
+#endif // BENCHMARK_H
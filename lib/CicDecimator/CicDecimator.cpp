@@ -0,0 +1,88 @@
+#include <CicDecimator.h>
+#include <MemoryReport.h>
+
+static const int32_t CIC_OUTPUT_MAX = 1023L << CIC_OUTPUT_FRAC_BITS;
+
+CicDecimator::CicDecimator()
+{
+    configure(3, 2, true);
+}
+
+bool CicDecimator::configure(uint8_t stages, uint8_t rateLog2, bool compensate)
+{
+    if (stages < 1 || stages > CIC_MAX_STAGES || rateLog2 > CIC_MAX_RATE_LOG2 ||
+        stages * rateLog2 + CIC_INPUT_BITS > CIC_REGISTER_BITS)
+    {
+        return false;
+    }
+    stages_ = stages;
+    rateLog2_ = rateLog2;
+    compensate_ = compensate;
+    output_ = 0;
+    reset();
+    return true;
+}
+
+uint32_t CicDecimator::delaySamples() const
+{
+    // CIC: N * (R - 1) / 2, a kompenzator egy kimeneti mintat tesz hozza
+    uint32_t rate = 1UL << rateLog2_;
+    return (stages_ * (rate - 1)) / 2 + (compensate_ ? rate : 0);
+}
+
+int32_t RAM_FUNC("cic") CicDecimator::combAndScale()
+{
+    uint32_t x = integrator_[stages_ - 1];
+    for (uint8_t s = 0; s < stages_; ++s)
+    {
+        uint32_t y = x - comb_[s];
+        comb_[s] = x;
+        x = y;
+    }
+    // Erosites R^N = 2^(N * rateLog2): normalizalas Q10.16-ra shifttel
+    uint8_t growth = stages_ * rateLog2_;
+    if (growth <= CIC_OUTPUT_FRAC_BITS)
+    {
+        return x << (CIC_OUTPUT_FRAC_BITS - growth);
+    }
+    uint8_t shift = growth - CIC_OUTPUT_FRAC_BITS;
+    return (x + (1UL << (shift - 1))) >> shift;
+}
+
+uint32_t RAM_FUNC("cic") CicDecimator::compensate(int32_t value)
+{
+    // Szimmetrikus [-1/8, 1 + 2/8, -1/8] szuro: a CIC esest a kimeneti savban emeli vissza
+    int32_t center = history_[1];
+    int32_t compensated = center + ((2 * center - history_[0] - value) >> CIC_COMP_SHIFT);
+    history_[0] = history_[1];
+    history_[1] = value;
+    if (compensated < 0)
+    {
+        return 0;
+    }
+    return compensated > CIC_OUTPUT_MAX ? CIC_OUTPUT_MAX : compensated;
+}
+
+void CicDecimator::prime(uint16_t sample)
+{
+    // Allando bemenetre N * R minta utan all be a CIC; ennyit tolunk at, majd a combokat
+    // es a kompenzatort a kimenethez igazitjuk. Csak az elso mintanal fut.
+    for (uint8_t s = 0; s < stages_; ++s)
+    {
+        integrator_[s] = 0;
+        comb_[s] = 0;
+    }
+    phase_ = 0;
+    primed_ = true;
+    uint32_t count = static_cast<uint32_t>(stages_ + 1) << rateLog2_;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        integrate(sample);
+        if (++phase_ == (1U << rateLog2_))
+        {
+            phase_ = 0;
+            combAndScale();
+        }
+    }
+    history_[0] = history_[1] = static_cast<int32_t>(sample) << CIC_OUTPUT_FRAC_BITS;
+}
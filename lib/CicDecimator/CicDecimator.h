@@ -0,0 +1,87 @@
+#ifndef CICDECIMATOR_H
+#define CICDECIMATOR_H
+
+#include <stdint.h>
+
+const uint8_t CIC_MAX_STAGES = 4;
+const uint8_t CIC_MAX_RATE_LOG2 = 6;    // legfeljebb 64-szeres decimalas
+const uint8_t CIC_INPUT_BITS = 10;      // MCP3008
+const uint8_t CIC_REGISTER_BITS = 32;   // bit novekedes: stages * rateLog2 + 10 <= 32
+const uint8_t CIC_OUTPUT_FRAC_BITS = 16; // kimenet Q10.16, mint az EMA allapot
+const uint8_t CIC_COMP_SHIFT = 3;       // kompenzator: y = x1 + (2 x1 - x0 - x2) / 8
+
+//
+// CicDecimator Class
+// Integer cascaded integrator-comb decimator for one channel: N integrators
+// at the input rate, N combs at the output rate, decimation by 2^rateLog2.
+// Only adds, subtracts and shifts; the registers wrap modulo 2^32, which
+// the combs cancel exactly as long as the bit growth fits. The output is
+// normalised to Q10.16 so the extra bits from averaging are kept. An
+// optional 3-tap shift-only FIR at the output rate flattens the CIC droop
+// in the passband (about one output sample of extra delay).
+//
+class CicDecimator {
+public:
+  CicDecimator();
+
+  // false, ha a parameterek nem ferek bele a 32 bites regiszterekbe
+  bool configure(uint8_t stages, uint8_t rateLog2, bool compensate);
+
+  // A kovetkezo minta ujra feltolti a szurot (nincs beallasi tranziens)
+  void reset() { primed_ = false; }
+
+  // Uj minta a bemeneti rataval; true, ha elkeszult egy kimeneti minta
+  inline bool push(uint16_t sample)
+  {
+    if (!primed_)
+    {
+      prime(sample);
+    }
+    integrate(sample);
+    if (++phase_ < (1U << rateLog2_))
+    {
+      return false;
+    }
+    phase_ = 0;
+    int32_t value = combAndScale();
+    output_ = compensate_ ? compensate(value) : value;
+    return true;
+  }
+
+  // Utolso kimeneti minta, Q10.16
+  uint32_t output() const { return output_; }
+
+  uint8_t stages() const { return stages_; }
+  uint8_t rateLog2() const { return rateLog2_; }
+  bool compensated() const { return compensate_; }
+
+  // Csoportkesleltetes bemeneti mintaban (a kompenzatorral egyutt)
+  uint32_t delaySamples() const;
+
+private:
+  inline void integrate(uint16_t sample)
+  {
+    uint32_t x = sample;
+    for (uint8_t s = 0; s < stages_; ++s)
+    {
+      integrator_[s] += x;
+      x = integrator_[s];
+    }
+  }
+
+  int32_t combAndScale();
+  uint32_t compensate(int32_t value);
+  void prime(uint16_t sample);
+
+  uint32_t integrator_[CIC_MAX_STAGES];
+  uint32_t comb_[CIC_MAX_STAGES];
+  int32_t history_[2]; // kompenzator: elozo ket CIC kimenet, Q10.16
+  uint32_t output_;
+  uint8_t stages_;
+  uint8_t rateLog2_;
+  uint8_t phase_;
+  bool compensate_;
+  bool primed_;
+};
+
+#endif // CICDECIMATOR_H
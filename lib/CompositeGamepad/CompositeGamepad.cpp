@@ -0,0 +1,77 @@
+#include "CompositeGamepad.h"
+#include "LatencyProbe.h"
+
+using namespace arduino;
+
+CompositeGamepad::CompositeGamepad(VirtualGamepad *const *devices, uint8_t count, uint16_t vendor_id, uint16_t product_id, uint16_t product_release)
+    : PicoGamepad(true, vendor_id, product_id, product_release), _count(0), _next_device(0), _report_descriptor_length(0)
+{
+    if (count > COMPOSITE_MAX_DEVICES)
+    {
+        count = COMPOSITE_MAX_DEVICES;
+    }
+    for (uint8_t i = 0; i < count; i++)
+    {
+        _devices[i] = devices[i];
+    }
+    _count = count;
+    memset(&_device_report, 0, sizeof(_device_report));
+}
+
+const uint8_t *CompositeGamepad::report_desc()
+{
+    // Az eszkozok collection-jei egymas utan; a layout nem valtozik, eleg egyszer
+    if (_report_descriptor_length == 0)
+    {
+        for (uint8_t i = 0; i < _count; i++)
+        {
+            _report_descriptor_length += _devices[i]->writeDescriptor(
+                _report_descriptor + _report_descriptor_length,
+                COMPOSITE_DESCRIPTOR_CAPACITY - _report_descriptor_length);
+        }
+    }
+    reportLength = _report_descriptor_length;
+    return _report_descriptor;
+}
+
+bool CompositeGamepad::send_device(uint8_t index, uint32_t now_us)
+{
+    if (index >= _count)
+    {
+        return false;
+    }
+    VirtualGamepad &gamepad = *_devices[index];
+
+    _send_mutex.lock();
+    _device_report.length = gamepad.reportLength();
+    memcpy(_device_report.data, gamepad.report(), gamepad.reportLength());
+    LATENCY_MARK(MARK_PACK_END);
+    bool sent = send_nb(&_device_report);
+    _send_mutex.unlock();
+
+    if (sent)
+    {
+        gamepad.markSent(now_us);
+    }
+    return sent;
+}
+
+uint8_t CompositeGamepad::poll(uint32_t now_us)
+{
+    // A blokkolo send() eszkozonkent egy host pollt varna ki, a report task tobb ms-ig futna
+    for (uint8_t n = 0; n < _count; n++)
+    {
+        uint8_t i = (_next_device + n) % _count;
+        if (!_devices[i]->isDue(now_us))
+        {
+            continue;
+        }
+        if (!send_device(i, now_us))
+        {
+            return 0; // endpoint foglalt: a kovetkezo poll ujra probalja
+        }
+        _next_device = (i + 1) % _count;
+        return 1;
+    }
+    return 0;
+}
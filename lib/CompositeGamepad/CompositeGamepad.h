@@ -0,0 +1,52 @@
+#ifndef CompositeGamepad_H
+#define CompositeGamepad_H
+
+#include "PicoGamepad.h"
+#include "VirtualGamepad.h"
+
+#define COMPOSITE_MAX_DEVICES 4
+#define COMPOSITE_DESCRIPTOR_CAPACITY (COMPOSITE_MAX_DEVICES * 128)
+
+namespace arduino
+{
+
+    //
+    // CompositeGamepad Class
+    // Several logical game controllers (pedals, throttle quadrant, panel...)
+    // on one USB device. Each VirtualGamepad is its own top-level application
+    // collection with its own report ID, so the host lists them as separate
+    // controllers, and each one sends only its own short report at its own
+    // rate. The interface/endpoint layout is PicoGamepad::configuration_desc;
+    // only the report descriptor is generated from the device layouts.
+    //
+    class CompositeGamepad : public PicoGamepad
+    {
+    public:
+        CompositeGamepad(VirtualGamepad *const *devices, uint8_t count, uint16_t vendor_id = 0x1235, uint16_t product_id = 0x0051, uint16_t product_release = 0x0001);
+
+        uint8_t device_count() const { return _count; }
+        VirtualGamepad &device(uint8_t index) { return *_devices[index]; }
+
+        // Egy eszkoz reportjanak kuldese (csak a sajat, rovid report); nem blokkol: false, ha
+        // az endpoint meg foglalt, ekkor az eszkoz esedekes marad
+        bool send_device(uint8_t index, uint32_t now_us);
+
+        // Legfeljebb egy esedekes (valtozott es lejart intervallumu) eszkoz kuldese, korben
+        // valtva; a kuldott reportok szama (0 vagy 1). Egy IN endpoint, a host 1 ms-onkent
+        // egy reportot vesz at, igy a task sosem var a hostra.
+        uint8_t poll(uint32_t now_us);
+
+        virtual const uint8_t *report_desc();
+
+    private:
+        VirtualGamepad *_devices[COMPOSITE_MAX_DEVICES];
+        uint8_t _count;
+        uint8_t _next_device; // a kovetkezo poll() innen keres
+        uint8_t _report_descriptor[COMPOSITE_DESCRIPTOR_CAPACITY];
+        uint16_t _report_descriptor_length;
+        HID_REPORT _device_report;
+        PlatformMutex _send_mutex;
+    };
+}
+
+#endif
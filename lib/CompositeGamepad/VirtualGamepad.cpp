@@ -0,0 +1,159 @@
+#include <VirtualGamepad.h>
+#include <string.h>
+
+static const uint8_t AXIS_USAGES[VIRTUAL_MAX_AXES] = {
+    0x30, // X
+    0x31, // Y
+    0x32, // Z
+    0x33, // Rx
+    0x34, // Ry
+    0x35, // Rz
+    0x36, // Slider
+    0x37, // Dial
+};
+
+static const uint8_t HAT_CENTER = 8;
+
+VirtualGamepad::VirtualGamepad(const GamepadLayout &layout)
+    : layout_(layout), dirty_(true), lastSentUs_(0)
+{
+    if (layout_.buttons > VIRTUAL_MAX_BUTTONS)
+        layout_.buttons = VIRTUAL_MAX_BUTTONS;
+    if (layout_.axes > VIRTUAL_MAX_AXES)
+        layout_.axes = VIRTUAL_MAX_AXES;
+    if (layout_.hats > VIRTUAL_MAX_HATS)
+        layout_.hats = VIRTUAL_MAX_HATS;
+
+    axisOffset_ = 1 + (layout_.buttons + 7) / 8;
+    hatOffset_ = axisOffset_ + 2 * layout_.axes;
+    length_ = hatOffset_ + (layout_.hats + 1) / 2;
+
+    memset(report_, 0, sizeof(report_));
+    report_[0] = layout_.reportId;
+    for (uint8_t i = 0; i < layout_.hats; ++i)
+    {
+        setHat(i, HAT_CENTER);
+    }
+}
+
+void VirtualGamepad::setButton(uint8_t index, bool pressed)
+{
+    if (index >= layout_.buttons)
+    {
+        return;
+    }
+    uint8_t &byte = report_[1 + index / 8];
+    uint8_t mask = 1 << (index % 8);
+    uint8_t updated = pressed ? (byte | mask) : (byte & ~mask);
+    dirty_ |= updated != byte;
+    byte = updated;
+}
+
+void VirtualGamepad::setAxis(uint8_t index, int16_t value)
+{
+    if (index >= layout_.axes)
+    {
+        return;
+    }
+    uint8_t *p = &report_[axisOffset_ + 2 * index];
+    uint8_t lsb = static_cast<uint16_t>(value) & 0xFF;
+    uint8_t msb = static_cast<uint16_t>(value) >> 8;
+    dirty_ |= p[0] != lsb || p[1] != msb;
+    p[0] = lsb;
+    p[1] = msb;
+}
+
+void VirtualGamepad::setHat(uint8_t index, uint8_t direction)
+{
+    if (index >= layout_.hats || direction > HAT_CENTER)
+    {
+        return;
+    }
+    uint8_t &hats = report_[hatOffset_ + index / 2];
+    uint8_t updated = (index & 1) ? (hats & 0x0F) | (direction << 4) : (hats & 0xF0) | direction;
+    dirty_ |= updated != hats;
+    hats = updated;
+}
+
+bool VirtualGamepad::isDue(uint32_t nowUs) const
+{
+    return dirty_ && static_cast<int32_t>(nowUs - lastSentUs_) >= static_cast<int32_t>(layout_.intervalUs);
+}
+
+uint16_t VirtualGamepad::writeDescriptor(uint8_t *out, uint16_t capacity) const
+{
+    uint8_t d[128];
+    uint16_t n = 0;
+
+    d[n++] = 0x05; d[n++] = 0x01;              // USAGE_PAGE (Generic Desktop)
+    d[n++] = 0x09; d[n++] = layout_.usage;     // USAGE (Joystick / Gamepad)
+    d[n++] = 0xA1; d[n++] = 0x01;              // COLLECTION (Application)
+    d[n++] = 0x85; d[n++] = layout_.reportId;  // REPORT_ID
+
+    if (layout_.buttons)
+    {
+        uint8_t padding = (8 - layout_.buttons % 8) % 8;
+        d[n++] = 0x05; d[n++] = 0x09;              // USAGE_PAGE (Button)
+        d[n++] = 0x19; d[n++] = 0x01;              // USAGE_MINIMUM (Button 1)
+        d[n++] = 0x29; d[n++] = layout_.buttons;   // USAGE_MAXIMUM
+        d[n++] = 0x15; d[n++] = 0x00;              // LOGICAL_MINIMUM (0)
+        d[n++] = 0x25; d[n++] = 0x01;              // LOGICAL_MAXIMUM (1)
+        d[n++] = 0x75; d[n++] = 0x01;              // REPORT_SIZE (1)
+        d[n++] = 0x95; d[n++] = layout_.buttons;   // REPORT_COUNT
+        d[n++] = 0x81; d[n++] = 0x02;              // INPUT (Data,Var,Abs)
+        if (padding)
+        {
+            d[n++] = 0x75; d[n++] = 0x01;          // REPORT_SIZE (1)
+            d[n++] = 0x95; d[n++] = padding;       // REPORT_COUNT
+            d[n++] = 0x81; d[n++] = 0x03;          // INPUT (Cnst,Var,Abs)
+        }
+    }
+
+    if (layout_.axes)
+    {
+        d[n++] = 0x05; d[n++] = 0x01;              // USAGE_PAGE (Generic Desktop)
+        for (uint8_t i = 0; i < layout_.axes; ++i)
+        {
+            d[n++] = 0x09; d[n++] = AXIS_USAGES[i]; // USAGE
+        }
+        d[n++] = 0x16; d[n++] = 0x01; d[n++] = 0x80; // LOGICAL_MINIMUM (-32767)
+        d[n++] = 0x26; d[n++] = 0xFF; d[n++] = 0x7F; // LOGICAL_MAXIMUM (32767)
+        d[n++] = 0x75; d[n++] = 0x10;              // REPORT_SIZE (16)
+        d[n++] = 0x95; d[n++] = layout_.axes;      // REPORT_COUNT
+        d[n++] = 0x81; d[n++] = 0x02;              // INPUT (Data,Var,Abs)
+    }
+
+    if (layout_.hats)
+    {
+        d[n++] = 0x05; d[n++] = 0x01;              // USAGE_PAGE (Generic Desktop)
+        d[n++] = 0x15; d[n++] = 0x00;              // LOGICAL_MINIMUM (0)
+        d[n++] = 0x25; d[n++] = 0x07;              // LOGICAL_MAXIMUM (7)
+        d[n++] = 0x35; d[n++] = 0x00;              // PHYSICAL_MINIMUM (0)
+        d[n++] = 0x46; d[n++] = 0x3B; d[n++] = 0x01; // PHYSICAL_MAXIMUM (315)
+        d[n++] = 0x65; d[n++] = 0x14;              // UNIT (Eng Rot:Angular Pos)
+        d[n++] = 0x75; d[n++] = 0x04;              // REPORT_SIZE (4)
+        for (uint8_t i = 0; i < layout_.hats; ++i)
+        {
+            d[n++] = 0x09; d[n++] = 0x39;          // USAGE (Hat switch)
+            d[n++] = 0x95; d[n++] = 0x01;          // REPORT_COUNT (1)
+            d[n++] = 0x81; d[n++] = 0x42;          // INPUT (Data,Var,Abs,Null)
+        }
+        if (layout_.hats & 1)
+        {
+            d[n++] = 0x95; d[n++] = 0x01;          // REPORT_COUNT (1)
+            d[n++] = 0x81; d[n++] = 0x03;          // INPUT (Cnst) kitoltes
+        }
+        // A globalis elemek oroklodnek: a kovetkezo eszkoz tengelyei ne kapjak meg a 0..315 fokot
+        d[n++] = 0x45; d[n++] = 0x00;              // PHYSICAL_MAXIMUM (0)
+        d[n++] = 0x65; d[n++] = 0x00;              // UNIT (None)
+    }
+
+    d[n++] = 0xC0;                                 // END_COLLECTION
+
+    if (n > capacity)
+    {
+        return 0;
+    }
+    memcpy(out, d, n);
+    return n;
+}
@@ -0,0 +1,59 @@
+#ifndef VIRTUALGAMEPAD_H
+#define VIRTUALGAMEPAD_H
+
+#include <stdint.h>
+
+const uint8_t VIRTUAL_MAX_BUTTONS = 32;
+const uint8_t VIRTUAL_MAX_AXES = 8;    // X, Y, Z, Rx, Ry, Rz, Slider, Dial
+const uint8_t VIRTUAL_MAX_HATS = 2;
+// report ID + gombok + 16 bites tengelyek + 4 bites hat-ek
+const uint8_t VIRTUAL_MAX_REPORT = 1 + VIRTUAL_MAX_BUTTONS / 8 + 2 * VIRTUAL_MAX_AXES + (VIRTUAL_MAX_HATS + 1) / 2;
+
+// Egy logikai eszkoz leirasa
+struct GamepadLayout
+{
+  uint8_t reportId;     // 1..255, eszkozonkent egyedi
+  uint8_t usage;        // 0x04 Joystick, 0x05 Gamepad
+  uint8_t buttons;      // 0..VIRTUAL_MAX_BUTTONS
+  uint8_t axes;         // 0..VIRTUAL_MAX_AXES
+  uint8_t hats;         // 0..VIRTUAL_MAX_HATS
+  uint32_t intervalUs;  // legrovidebb ido ket report kozott
+};
+
+//
+// VirtualGamepad Class
+// One logical game controller inside the composite device: its own report
+// ID, report buffer and send interval. The report descriptor collection is
+// generated from the layout, so report and descriptor always agree.
+//
+class VirtualGamepad {
+public:
+  VirtualGamepad(const GamepadLayout &layout);
+
+  void setButton(uint8_t index, bool pressed);
+  void setAxis(uint8_t index, int16_t value);
+  void setHat(uint8_t index, uint8_t direction); // 0-7 orajarassal, 8 = kozep
+
+  const GamepadLayout &layout() const { return layout_; }
+  const uint8_t *report() const { return report_; }
+  uint8_t reportLength() const { return length_; }
+
+  // Valtozott-e az utolso kuldes ota
+  bool isDirty() const { return dirty_; }
+  void markSent(uint32_t nowUs) { dirty_ = false; lastSentUs_ = nowUs; }
+  bool isDue(uint32_t nowUs) const;
+
+  // A top-level collection a report descriptorba; visszaadja a hosszat, 0 ha nem fer el
+  uint16_t writeDescriptor(uint8_t *out, uint16_t capacity) const;
+
+private:
+  GamepadLayout layout_;
+  uint8_t axisOffset_;
+  uint8_t hatOffset_;
+  uint8_t length_;
+  bool dirty_;
+  uint32_t lastSentUs_;
+  uint8_t report_[VIRTUAL_MAX_REPORT];
+};
+
+#endif // VIRTUALGAMEPAD_H
@@ -0,0 +1,497 @@
+#include <I2CBus.h>
+#include <string.h>
+
+static const uint8_t SSD1306_CONTROL_COMMAND = 0x00;
+static const uint8_t SSD1306_CONTROL_DATA = 0x40;
+// Teljes kepernyo ablak (128 oszlop), mint az Adafruit display()
+static const uint8_t DISPLAY_WINDOW[] = {0x22, 0x00, 0xFF, 0x21, 0x00, 0x7F};
+
+I2CBus::I2CBus(TwoWire *wire)
+    : wire_(wire)
+{
+    for (Job &job : jobs_)
+    {
+        job.type = JOB_NONE;
+    }
+}
+
+bool I2CBus::addDevice(uint8_t address, uint32_t maxClockHz)
+{
+    if (deviceCount_ >= I2C_MAX_DEVICES)
+    {
+        return false;
+    }
+    deviceAddress_[deviceCount_] = address;
+    deviceClock_[deviceCount_] = maxClockHz;
+    deviceCount_++;
+
+    // Fast-mode Plus csak akkor, ha minden eszkoz birja; kulonben Fast-mode (vagy lassabb)
+    clockHz_ = I2C_FAST_MODE_PLUS_HZ;
+    for (uint8_t i = 0; i < deviceCount_; ++i)
+    {
+        if (deviceClock_[i] < clockHz_)
+        {
+            clockHz_ = deviceClock_[i];
+        }
+    }
+    return true;
+}
+
+void I2CBus::begin()
+{
+    wire_->begin();
+    wire_->setClock(clockHz_);
+}
+
+void I2CBus::setBudget(uint32_t budgetUs)
+{
+    budgetUs_ = budgetUs ? budgetUs : 1;
+}
+
+bool I2CBus::probe(uint8_t address)
+{
+    wire_->beginTransmission(address);
+    return wire_->endTransmission() == 0;
+}
+
+// Start + cim bajt + adat, bajtonkent 9 orajel, plusz stop
+uint32_t I2CBus::transferUs(uint16_t bytes) const
+{
+    return ((bytes + 1) * 9UL + 2) * 1000000UL / clockHz_ + 1;
+}
+
+// A budgetbe fero hasznos bajtok szama egy tranzakcioban, overhead bajt (cim, vezerlo bajt) mellett
+uint16_t I2CBus::chunkLimit(uint8_t overhead) const
+{
+    uint32_t bits = budgetUs_ * (clockHz_ / 1000UL) / 1000UL;
+    uint32_t bytes = bits > 2 ? (bits - 2) / 9 : 0;
+    bytes = bytes > 1UL + overhead ? bytes - 1 - overhead : 1;
+    return bytes < static_cast<uint32_t>(I2C_MAX_CHUNK - overhead) ? bytes : I2C_MAX_CHUNK - overhead;
+}
+
+bool I2CBus::known(uint8_t address) const
+{
+    for (uint8_t i = 0; i < deviceCount_; ++i)
+    {
+        if (deviceAddress_[i] == address)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t I2CBus::freeSlots() const
+{
+    uint8_t count = 0;
+    for (const Job &job : jobs_)
+    {
+        count += job.type == JOB_NONE;
+    }
+    return count;
+}
+
+uint8_t I2CBus::pending() const
+{
+    return I2C_QUEUE_LENGTH - freeSlots();
+}
+
+I2CBus::Job *I2CBus::allocate(JobType type, uint8_t address, volatile I2CJobStatus *status)
+{
+    // Csak regisztralt eszkoz kap munkat, a tobbi soha nem kerulne sorra
+    if (!known(address))
+    {
+        return nullptr;
+    }
+    for (Job &job : jobs_)
+    {
+        if (job.type == JOB_NONE)
+        {
+            job.type = type;
+            job.state = STATE_START;
+            job.address = address;
+            job.last = true;
+            job.sequence = sequence_++;
+            job.offset = 0;
+            job.retries = 0;
+            job.source = nullptr;
+            job.destination = nullptr;
+            job.status = status;
+            return &job;
+        }
+    }
+    return nullptr;
+}
+
+bool I2CBus::writeMemory(uint8_t address, uint16_t memoryAddress, const void *data, uint16_t length,
+                         volatile I2CJobStatus *status)
+{
+    // Lap hataron es munkankent I2C_JOB_DATA bajtonkent bontva; vagy az egesz kerul a sorba, vagy semmi
+    uint16_t pieces = 0;
+    for (uint16_t done = 0; done < length; ++pieces)
+    {
+        uint16_t pageLeft = I2C_EEPROM_PAGE - ((memoryAddress + done) & (I2C_EEPROM_PAGE - 1));
+        uint16_t chunk = length - done < pageLeft ? length - done : pageLeft;
+        done += chunk < I2C_JOB_DATA ? chunk : I2C_JOB_DATA;
+    }
+    if (length == 0 || pieces > freeSlots() || !known(address))
+    {
+        return false;
+    }
+    if (status)
+    {
+        *status = I2C_JOB_PENDING;
+    }
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    uint16_t done = 0;
+    while (done < length)
+    {
+        uint16_t pageLeft = I2C_EEPROM_PAGE - ((memoryAddress + done) & (I2C_EEPROM_PAGE - 1));
+        uint16_t chunk = length - done < pageLeft ? length - done : pageLeft;
+        chunk = chunk < I2C_JOB_DATA ? chunk : I2C_JOB_DATA;
+        Job *job = allocate(JOB_MEMORY_WRITE, address, status);
+        job->memoryAddress = memoryAddress + done;
+        job->length = chunk;
+        memcpy(job->data, bytes + done, chunk);
+        done += chunk;
+        job->last = done == length;
+    }
+    return true;
+}
+
+bool I2CBus::readMemory(uint8_t address, uint16_t memoryAddress, void *destination, uint16_t length,
+                        volatile I2CJobStatus *status)
+{
+    if (length == 0)
+    {
+        return false;
+    }
+    Job *job = allocate(JOB_MEMORY_READ, address, status);
+    if (!job)
+    {
+        return false;
+    }
+    if (status)
+    {
+        *status = I2C_JOB_PENDING;
+    }
+    job->memoryAddress = memoryAddress;
+    job->length = length;
+    job->destination = static_cast<uint8_t *>(destination);
+    return true;
+}
+
+bool I2CBus::sendCommands(uint8_t address, const uint8_t *commands, uint16_t length,
+                          volatile I2CJobStatus *status)
+{
+    Job *job = length ? allocate(JOB_COMMANDS, address, status) : nullptr;
+    if (!job)
+    {
+        return false;
+    }
+    if (status)
+    {
+        *status = I2C_JOB_PENDING;
+    }
+    job->source = commands;
+    job->length = length;
+    return true;
+}
+
+bool I2CBus::flushDisplay(uint8_t address, const uint8_t *buffer, uint16_t length,
+                          volatile I2CJobStatus *status)
+{
+    // Egy meg el nem kezdett flush ugyis a legfrissebb buffert kuldi
+    for (const Job &job : jobs_)
+    {
+        if (job.type == JOB_DISPLAY && job.address == address && job.state == STATE_START)
+        {
+            return true;
+        }
+    }
+    Job *job = length ? allocate(JOB_DISPLAY, address, status) : nullptr;
+    if (!job)
+    {
+        return false;
+    }
+    if (status)
+    {
+        *status = I2C_JOB_PENDING;
+    }
+    job->source = buffer;
+    job->length = length;
+    return true;
+}
+
+bool I2CBus::runnable(const Job &job, uint32_t nowUs) const
+{
+    return job.state != STATE_ACK_POLL || nowUs - job.pollUs >= I2C_ACK_POLL_US;
+}
+
+// Korben a kovetkezo eszkoz legregebbi munkaja, ha futtathato
+I2CBus::Job *I2CBus::nextJob(uint32_t nowUs)
+{
+    uint8_t first = 0;
+    for (uint8_t i = 0; i < deviceCount_; ++i)
+    {
+        if (deviceAddress_[i] == lastAddress_)
+        {
+            first = i + 1;
+        }
+    }
+    for (uint8_t n = 0; n < deviceCount_; ++n)
+    {
+        uint8_t address = deviceAddress_[(first + n) % deviceCount_];
+        Job *oldest = nullptr;
+        for (Job &job : jobs_)
+        {
+            if (job.type != JOB_NONE && job.address == address &&
+                (!oldest || static_cast<int32_t>(job.sequence - oldest->sequence) < 0))
+            {
+                oldest = &job;
+            }
+        }
+        if (oldest && runnable(*oldest, nowUs))
+        {
+            lastAddress_ = address;
+            return oldest;
+        }
+    }
+    return nullptr;
+}
+
+uint32_t I2CBus::estimateUs(const Job &job) const
+{
+    uint16_t left = job.length - job.offset;
+    switch (job.type)
+    {
+    case JOB_MEMORY_WRITE:
+        if (job.state == STATE_ACK_POLL)
+        {
+            return transferUs(0);
+        }
+        return transferUs(2 + (left < chunkLimit(2) ? left : chunkLimit(2)));
+    case JOB_MEMORY_READ:
+        if (job.state == STATE_START)
+        {
+            return transferUs(2);
+        }
+        return transferUs(left < chunkLimit(0) ? left : chunkLimit(0));
+    case JOB_DISPLAY:
+        if (job.state == STATE_START)
+        {
+            return transferUs(1 + sizeof(DISPLAY_WINDOW));
+        }
+        // fall through
+    case JOB_COMMANDS:
+        return transferUs(1 + (left < chunkLimit(1) ? left : chunkLimit(1)));
+    default:
+        return 0;
+    }
+}
+
+void I2CBus::finish(Job &job, bool ok)
+{
+    job.type = JOB_NONE;
+    if (!ok)
+    {
+        failed_++;
+        if (job.status)
+        {
+            *job.status = I2C_JOB_FAILED;
+            // A kert muvelet tobbi darabja sem fut le
+            for (Job &other : jobs_)
+            {
+                if (other.type != JOB_NONE && other.status == job.status)
+                {
+                    other.type = JOB_NONE;
+                }
+            }
+        }
+        return;
+    }
+    if (job.last && job.status && *job.status != I2C_JOB_FAILED)
+    {
+        *job.status = I2C_JOB_DONE;
+    }
+}
+
+bool I2CBus::step(Job &job, uint32_t nowUs)
+{
+    uint16_t left = job.length - job.offset;
+    switch (job.type)
+    {
+    case JOB_MEMORY_WRITE:
+    {
+        if (job.state == STATE_ACK_POLL)
+        {
+            // Iras ciklus alatt a chip nem ACK-zik; ha mar igen, johet a kovetkezo lap
+            job.pollUs = nowUs;
+            ackPolls_++;
+            if (probe(job.address))
+            {
+                if (job.offset == job.length)
+                {
+                    finish(job, true);
+                    return true;
+                }
+                job.state = STATE_START;
+                return false;
+            }
+            if (nowUs - job.writeUs > I2C_WRITE_TIMEOUT_US)
+            {
+                finish(job, false);
+                return true;
+            }
+            return false;
+        }
+        uint16_t chunk = left < chunkLimit(2) ? left : chunkLimit(2);
+        uint16_t target = job.memoryAddress + job.offset;
+        wire_->beginTransmission(job.address);
+        wire_->write(static_cast<uint8_t>(target >> 8));
+        wire_->write(static_cast<uint8_t>(target & 0xFF));
+        wire_->write(job.data + job.offset, chunk);
+        // NACK eseten a chip meg iras ciklusban lehet: ACK polling, majd ugyanez a lap ujra.
+        // Ha a cimet ACK-zza, de az adatot tobbszor sem, a munka hibaval zarul, kulonben a sort
+        // es a tobbi eszkozt orokre feltartana.
+        if (wire_->endTransmission() == 0)
+        {
+            job.offset += chunk;
+            job.retries = 0;
+        }
+        else if (++job.retries > I2C_WRITE_RETRIES)
+        {
+            finish(job, false);
+            return true;
+        }
+        job.state = STATE_ACK_POLL;
+        job.writeUs = nowUs;
+        job.pollUs = nowUs;
+        return false;
+    }
+
+    case JOB_MEMORY_READ:
+        if (job.state == STATE_START)
+        {
+            uint16_t source = job.memoryAddress + job.offset;
+            wire_->beginTransmission(job.address);
+            wire_->write(static_cast<uint8_t>(source >> 8));
+            wire_->write(static_cast<uint8_t>(source & 0xFF));
+            if (wire_->endTransmission() != 0)
+            {
+                finish(job, false);
+                return true;
+            }
+            job.state = STATE_READING;
+            return false;
+        }
+        else
+        {
+            uint16_t chunk = left < chunkLimit(0) ? left : chunkLimit(0);
+            if (wire_->requestFrom(job.address, static_cast<size_t>(chunk)) != chunk)
+            {
+                finish(job, false);
+                return true;
+            }
+            for (uint16_t i = 0; i < chunk; ++i)
+            {
+                job.destination[job.offset + i] = wire_->read();
+            }
+            job.offset += chunk;
+            if (job.offset == job.length)
+            {
+                finish(job, true);
+                return true;
+            }
+            return false;
+        }
+
+    case JOB_DISPLAY:
+    case JOB_COMMANDS:
+    {
+        bool window = job.type == JOB_DISPLAY && job.state == STATE_START;
+        uint16_t chunk = left < chunkLimit(1) ? left : chunkLimit(1);
+        wire_->beginTransmission(job.address);
+        if (window)
+        {
+            wire_->write(SSD1306_CONTROL_COMMAND);
+            wire_->write(DISPLAY_WINDOW, sizeof(DISPLAY_WINDOW));
+        }
+        else
+        {
+            wire_->write(job.type == JOB_DISPLAY ? SSD1306_CONTROL_DATA : SSD1306_CONTROL_COMMAND);
+            wire_->write(job.source + job.offset, chunk);
+        }
+        if (wire_->endTransmission() != 0)
+        {
+            finish(job, false);
+            return true;
+        }
+        if (window)
+        {
+            job.state = STATE_DATA;
+            return false;
+        }
+        job.offset += chunk;
+        if (job.offset == job.length)
+        {
+            finish(job, true);
+            return true;
+        }
+        return false;
+    }
+
+    default:
+        job.type = JOB_NONE;
+        return true;
+    }
+}
+
+void I2CBus::service()
+{
+    uint32_t used = 0;
+    while (true)
+    {
+        uint32_t nowUs = micros();
+        Job *job = nextJob(nowUs);
+        // Legalabb egy tranzakcio, utana csak ami meg belefer
+        if (!job || (used && used + estimateUs(*job) > budgetUs_))
+        {
+            break;
+        }
+        step(*job, nowUs);
+        uint32_t elapsed = micros() - nowUs;
+        transactions_++;
+        if (elapsed > longestUs_)
+        {
+            longestUs_ = elapsed;
+        }
+        used += elapsed;
+    }
+}
+
+void I2CBus::printStats(Print &out) const
+{
+    out.print("#I2C,");
+    out.print(clockHz_);
+    out.print(',');
+    out.print(budgetUs_);
+    out.print(',');
+    out.print(transactions_);
+    out.print(',');
+    out.print(longestUs_);
+    out.print(',');
+    out.print(ackPolls_);
+    out.print(',');
+    out.print(failed_);
+    out.print(',');
+    out.println(pending());
+}
+
+void I2CBus::resetStats()
+{
+    transactions_ = 0;
+    longestUs_ = 0;
+    ackPolls_ = 0;
+    failed_ = 0;
+}
@@ -0,0 +1,151 @@
+#ifndef I2CBUS_H
+#define I2CBUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdint.h>
+
+const uint8_t I2C_QUEUE_LENGTH = 12;         // egyszerre sorban allo munkak (egy profil mentes ~7)
+const uint8_t I2C_MAX_DEVICES = 4;
+const uint8_t I2C_JOB_DATA = 32;             // iras munkankent, bemasolva (EEPROM lap)
+const uint8_t I2C_MAX_CHUNK = 32;            // Wire puffer / EEPROM lap
+const uint8_t I2C_EEPROM_PAGE = 32;          // 24LC64
+const uint32_t I2C_DEFAULT_BUDGET_US = 500;  // egy task futas ennyi buszidot hasznalhat
+const uint32_t I2C_ACK_POLL_US = 200;        // EEPROM iras ciklus alatt ilyen surun probalja
+const uint32_t I2C_WRITE_TIMEOUT_US = 10000; // 24LC64: legfeljebb 5 ms iras ciklus
+const uint8_t I2C_WRITE_RETRIES = 3;         // egy lap adatanak NACK-ja utan ennyi ujraprobalas
+const uint32_t I2C_FAST_MODE_HZ = 400000;
+const uint32_t I2C_FAST_MODE_PLUS_HZ = 1000000;
+
+enum I2CJobStatus : uint8_t
+{
+  I2C_JOB_PENDING,
+  I2C_JOB_DONE,
+  I2C_JOB_FAILED
+};
+
+//
+// I2CBus Class
+// Transaction queue for a shared I2C bus. Drivers do not own the bus any
+// more: they queue work (EEPROM page reads and writes, display command
+// lists and frame buffer flushes) and service() runs it from a scheduler
+// task as short transactions, each sized so it fits the time budget, and
+// never more than the budget per call. Devices take turns, so display
+// chunks interleave with EEPROM traffic; jobs of one device keep their
+// order. After an EEPROM page write the chip is ACK-polled every
+// I2C_ACK_POLL_US instead of waiting out the write cycle, and the other
+// devices use the bus meanwhile. The bus clock is the fastest one every
+// registered device supports (Fast-mode Plus only if all of them do).
+//
+class I2CBus {
+public:
+  I2CBus(TwoWire *wire);
+
+  // Eszkoz es a legnagyobb orajele; a busz orajele ezek minimuma
+  bool addDevice(uint8_t address, uint32_t maxClockHz);
+
+  // Wire inditasa a kozos orajellel
+  void begin();
+  uint32_t clock() const { return clockHz_; }
+
+  // Egy tranzakcio alatt legfeljebb ennyi buszido (a darabolas is ebbol szamol)
+  void setBudget(uint32_t budgetUs);
+  uint32_t budget() const { return budgetUs_; }
+
+  // Jelen van-e az eszkoz; rovid, szinkron cim tranzakcio (inditaskor)
+  bool probe(uint8_t address);
+
+  // EEPROM iras lapokra bontva; az adat bemasolodik. false, ha nincs eleg hely a sorban
+  bool writeMemory(uint8_t address, uint16_t memoryAddress, const void *data, uint16_t length,
+                   volatile I2CJobStatus *status = nullptr);
+
+  // EEPROM olvasas a celpufferbe; a puffernek a befejezesig elnie kell
+  bool readMemory(uint8_t address, uint16_t memoryAddress, void *destination, uint16_t length,
+                  volatile I2CJobStatus *status = nullptr);
+
+  // SSD1306 parancsok (0x00 vezerlo bajt); a listanak a befejezesig elnie kell
+  bool sendCommands(uint8_t address, const uint8_t *commands, uint16_t length,
+                    volatile I2CJobStatus *status = nullptr);
+
+  // SSD1306 teljes frame buffer kuldese; ha meg el sem kezdodott egy, nem kerul uj a sorba
+  bool flushDisplay(uint8_t address, const uint8_t *buffer, uint16_t length,
+                    volatile I2CJobStatus *status = nullptr);
+
+  // Tranzakciok futtatasa a budget erejeig (scheduler task)
+  void service();
+
+  // Sorban allo munkak szama
+  uint8_t pending() const;
+  bool idle() const { return pending() == 0; }
+
+  // "#I2C,clock_hz,budget_us,transactions,longest_us,ack_polls,failed,pending"
+  void printStats(Print &out) const;
+  void resetStats();
+
+private:
+  enum JobType : uint8_t
+  {
+    JOB_NONE,
+    JOB_MEMORY_WRITE,
+    JOB_MEMORY_READ,
+    JOB_COMMANDS,
+    JOB_DISPLAY
+  };
+
+  enum JobState : uint8_t
+  {
+    STATE_START,     // kovetkezo tranzakcio
+    STATE_READING,   // memoria mutato beallitva, olvasas darabokban
+    STATE_DATA,      // kijelzo: ablak elkuldve, adat darabokban
+    STATE_ACK_POLL   // EEPROM iras ciklus vege
+  };
+
+  struct Job
+  {
+    JobType type;
+    JobState state;
+    uint8_t address;
+    bool last;                     // a kert muvelet utolso darabja (status ekkor DONE)
+    uint32_t sequence;             // eszkozonkent ebben a sorrendben futnak
+    uint16_t memoryAddress;
+    uint16_t length;
+    uint16_t offset;
+    const uint8_t *source;
+    uint8_t *destination;
+    uint32_t writeUs;              // utolso lap iras ideje (ACK polling)
+    uint32_t pollUs;               // utolso ACK probalkozas
+    uint8_t retries;               // az aktualis lap NACK-olt irasai
+    volatile I2CJobStatus *status;
+    uint8_t data[I2C_JOB_DATA];
+  };
+
+  bool known(uint8_t address) const;
+  uint8_t freeSlots() const;
+  Job *allocate(JobType type, uint8_t address, volatile I2CJobStatus *status);
+  Job *nextJob(uint32_t nowUs);
+  bool runnable(const Job &job, uint32_t nowUs) const;
+  void finish(Job &job, bool ok);
+
+  // Egy tranzakcio; true, ha a munka vegzett (sikerrel vagy hibaval)
+  bool step(Job &job, uint32_t nowUs);
+  uint32_t estimateUs(const Job &job) const;
+  uint32_t transferUs(uint16_t bytes) const;
+  uint16_t chunkLimit(uint8_t overhead) const;
+
+  TwoWire *wire_;
+  Job jobs_[I2C_QUEUE_LENGTH];
+  uint8_t deviceAddress_[I2C_MAX_DEVICES];
+  uint32_t deviceClock_[I2C_MAX_DEVICES];
+  uint8_t deviceCount_ = 0;
+  uint8_t lastAddress_ = 0;        // korben valtjak egymast az eszkozok
+  uint32_t sequence_ = 0;
+  uint32_t clockHz_ = I2C_FAST_MODE_HZ;
+  uint32_t budgetUs_ = I2C_DEFAULT_BUDGET_US;
+
+  uint32_t transactions_ = 0;
+  uint32_t longestUs_ = 0;
+  uint32_t ackPolls_ = 0;
+  uint32_t failed_ = 0;
+};
+
+#endif // I2CBUS_H
@@ -0,0 +1,114 @@
+#include <LatencyProbe.h>
+
+#ifdef LATENCY_PROBE
+
+volatile uint32_t LatencyProbe::marks_[MARK_COUNT] = {0};
+LatencyHistogram LatencyProbe::stages_[STAGE_COUNT] = {};
+
+static const char *const STAGE_NAMES[STAGE_COUNT] = {
+    "adc", "filter", "map", "pack", "send", "end_to_end"};
+
+const char *LatencyProbe::stageName(LatencyStage s)
+{
+    return s < STAGE_COUNT ? STAGE_NAMES[s] : "?";
+}
+
+void LatencyProbe::record(LatencyStage s, uint32_t us)
+{
+    // Bucket index: a legmagasabb beallitott bit pozicioja + 1
+    uint8_t bucket = us ? 32 - __builtin_clz(us) : 0;
+    if (bucket >= LATENCY_BUCKETS)
+    {
+        bucket = LATENCY_BUCKETS - 1;
+    }
+
+    LatencyHistogram &h = stages_[s];
+    h.buckets[bucket]++;
+    h.count++;
+    h.sumUs += us;
+    if (us > h.maxUs)
+    {
+        h.maxUs = us;
+    }
+}
+
+void LatencyProbe::commit()
+{
+    uint32_t m[MARK_COUNT];
+    for (uint8_t i = 0; i < MARK_COUNT; ++i)
+    {
+        m[i] = marks_[i];
+    }
+
+    // uint32_t kivonas, igy a timer atfordulasa sem gond
+    record(STAGE_ADC, m[MARK_ADC_END] - m[MARK_ADC_START]);
+    record(STAGE_FILTER, m[MARK_FILTER_END] - m[MARK_ADC_END]);
+    record(STAGE_MAP, m[MARK_MAP_END] - m[MARK_MAP_START]);
+    record(STAGE_PACK, m[MARK_PACK_END] - m[MARK_MAP_END]);
+    record(STAGE_SEND, m[MARK_SEND_END] - m[MARK_PACK_END]);
+    record(STAGE_END_TO_END, m[MARK_SEND_END] - m[MARK_ADC_START]);
+}
+
+void LatencyProbe::reset()
+{
+    for (uint8_t s = 0; s < STAGE_COUNT; ++s)
+    {
+        stages_[s] = LatencyHistogram();
+    }
+}
+
+uint32_t LatencyProbe::percentile(LatencyStage s, uint8_t pct)
+{
+    const LatencyHistogram &h = stages_[s];
+    if (h.count == 0)
+    {
+        return 0;
+    }
+
+    // Rang felfele kerekitve, hogy pl. p99 10 mintabol a legnagyobbat adja
+    uint32_t rank = (static_cast<uint64_t>(h.count) * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < LATENCY_BUCKETS; ++b)
+    {
+        seen += h.buckets[b];
+        if (seen >= rank && seen > 0)
+        {
+            uint32_t upper = b ? (1UL << b) - 1 : 0;
+            return upper < h.maxUs ? upper : h.maxUs;
+        }
+    }
+    return h.maxUs;
+}
+
+void LatencyProbe::printReport(Print &out)
+{
+    // #LAT,<stage>,<count>,<avg>,<p50>,<p90>,<p99>,<max>,<b0>,...,<b15>
+    out.println("#LAT,stage,count,avg_us,p50_us,p90_us,p99_us,max_us,buckets...");
+    for (uint8_t i = 0; i < STAGE_COUNT; ++i)
+    {
+        LatencyStage s = static_cast<LatencyStage>(i);
+        const LatencyHistogram &h = stages_[s];
+        out.print("#LAT,");
+        out.print(stageName(s));
+        out.print(',');
+        out.print(h.count);
+        out.print(',');
+        out.print(h.count ? static_cast<uint32_t>(h.sumUs / h.count) : 0UL);
+        out.print(',');
+        out.print(percentile(s, 50));
+        out.print(',');
+        out.print(percentile(s, 90));
+        out.print(',');
+        out.print(percentile(s, 99));
+        out.print(',');
+        out.print(h.maxUs);
+        for (uint8_t b = 0; b < LATENCY_BUCKETS; ++b)
+        {
+            out.print(',');
+            out.print(h.buckets[b]);
+        }
+        out.println();
+    }
+}
+
+#endif // LATENCY_PROBE
@@ -0,0 +1,91 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <stdint.h>
+
+//
+// LatencyProbe
+// Timestamps the stages of one sample -> USB frame with the RP2040 microsecond
+// timer and accumulates per-stage log2 histograms in fixed RAM.
+// Build with -D LATENCY_PROBE (see [env:pico_latency]) to enable, otherwise
+// every LATENCY_* macro expands to nothing and the module is compiled out.
+//
+
+// Idopontok egy frame-en belul
+enum LatencyMark : uint8_t {
+  MARK_ADC_START = 0, // ADC olvasas kezdete
+  MARK_ADC_END,       // ADC olvasas vege
+  MARK_FILTER_END,    // szures vege
+  MARK_MAP_START,     // map-oles kezdete (report frame kezdete)
+  MARK_MAP_END,       // map-oles vege
+  MARK_PACK_END,      // report osszeallitva
+  MARK_SEND_END,      // send() visszatert
+  MARK_COUNT
+};
+
+// Mert szakaszok
+enum LatencyStage : uint8_t {
+  STAGE_ADC = 0,    // MARK_ADC_START -> MARK_ADC_END
+  STAGE_FILTER,     // MARK_ADC_END -> MARK_FILTER_END
+  STAGE_MAP,        // MARK_MAP_START -> MARK_MAP_END
+  STAGE_PACK,       // MARK_MAP_END -> MARK_PACK_END
+  STAGE_SEND,       // MARK_PACK_END -> MARK_SEND_END
+  STAGE_END_TO_END, // MARK_ADC_START -> MARK_SEND_END (a kikuldott minta kora)
+  STAGE_COUNT
+};
+
+#ifdef LATENCY_PROBE
+
+#include <Arduino.h>
+#include <hardware/timer.h>
+
+const uint8_t LATENCY_BUCKETS = 16; // log2 bucketek: [2^(k-1), 2^k) us, 0. bucket = 0 us
+
+struct LatencyHistogram
+{
+  uint32_t buckets[LATENCY_BUCKETS];
+  uint32_t count;
+  uint32_t maxUs;
+  uint64_t sumUs;
+};
+
+class LatencyProbe {
+public:
+  // Idobelyeg rogzitese az adott ponton
+  static inline void mark(LatencyMark m) { marks_[m] = time_us_32(); }
+
+  // A frame lezarasa: szakaszok kiszamitasa es a hisztogramok frissitese
+  static void commit();
+
+  // Hisztogramok torlese
+  static void reset();
+
+  // Szakasz statisztika lekerese
+  static const LatencyHistogram &stage(LatencyStage s) { return stages_[s]; }
+
+  // Percentilis (0-100) becslese a hisztogrambol, a bucket felso hatarat adja vissza us-ban
+  static uint32_t percentile(LatencyStage s, uint8_t pct);
+
+  // Emberi olvasasra es gepi feldolgozasra ("#LAT," sorok) alkalmas kiiras
+  static void printReport(Print &out);
+
+  static const char *stageName(LatencyStage s);
+
+private:
+  static void record(LatencyStage s, uint32_t us);
+
+  static volatile uint32_t marks_[MARK_COUNT];
+  static LatencyHistogram stages_[STAGE_COUNT];
+};
+
+#define LATENCY_MARK(m) LatencyProbe::mark(m)
+#define LATENCY_COMMIT() LatencyProbe::commit()
+
+#else
+
+#define LATENCY_MARK(m) ((void)0)
+#define LATENCY_COMMIT() ((void)0)
+
+#endif // LATENCY_PROBE
+
+#endif // LATENCYPROBE_H
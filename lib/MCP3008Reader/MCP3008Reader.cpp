@@ -1,4 +1,6 @@
 #include <MCP3008Reader.h>
+#include <LatencyProbe.h>
+#include <MemoryReport.h>
 
 MCP3008Reader::MCP3008Reader(Adafruit_MCP3008 *adc, 
                             const uint8_t channelNumber,
@@ -7,36 +9,332 @@ MCP3008Reader::MCP3008Reader(Adafruit_MCP3008 *adc,
 {
     arraySize_ = arraySize;
     CHANNEL_NUMBER_ = channelNumber;
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        emaShift_[ch] = EMA_SHIFT;
+        readOrder_[ch] = ch;
+    }
 }
 
 // Az csatornak ertekinek beolvasasa es tarolasa az adcValue_buffer_ vektorban
-void MCP3008Reader::readChannelsWithEMA()
+void RAM_FUNC("mcp3008_read") MCP3008Reader::readChannelsWithEMA()
+{
+    LATENCY_MARK(MARK_ADC_START);
+    uint32_t frameUs = micros();
+    reverseFrame_ = alternateOrder_ && !reverseFrame_;
+    for (uint8_t i = 0; i < CHANNEL_NUMBER_; ++i)
+    {
+        uint8_t ch = readOrder_[reverseFrame_ ? CHANNEL_NUMBER_ - 1 - i : i];
+        sampleUs_[ch] = micros();
+        rawValues_[ch] = (differentialMask_ & (1 << ch)) ? adc_->readADCDifference(ch) : adc_->readADC(ch);
+    }
+    frameUs_ = frameUs;
+    LATENCY_MARK(MARK_ADC_END);
+
+    // Frame-enkent egy osztas; kikapcsolva 1.0
+    uint32_t gainQ16 = referenceChannel_ >= 0 ? referenceGain() : 1UL << FILTER_FRAC_BITS;
+
+    // Az elso minta inditja az EMA-t; a ciklusbol kiemelve nincs csatornankenti elagazas
+    if (!emaSeeded_)
+    {
+        for (uint8_t ch = 0; ch < CHANNEL_NUMBER_; ++ch)
+        {
+            emaState_[ch] = static_cast<uint32_t>(rawValues_[ch]) << FILTER_FRAC_BITS;
+        }
+        emaSeeded_ = true;
+    }
+
+    bool decimated = false;
+    for (uint8_t ch = 0; ch < CHANNEL_NUMBER_; ++ch)
+    {
+        uint16_t value = rawValues_[ch];
+        uint32_t target = static_cast<uint32_t>(value) << FILTER_FRAC_BITS;
+        if (correctMask_ & (1 << ch))
+        {
+            // A median elott, igy a korrekcio az ugyanabban a frame-ben mert referenciaval tortenik;
+            // median nelkul a tort bitek is megmaradnak
+            target = value * gainQ16;
+            if (target > (static_cast<uint32_t>(MAX_ADC_VALUE) << FILTER_FRAC_BITS))
+            {
+                target = static_cast<uint32_t>(MAX_ADC_VALUE) << FILTER_FRAC_BITS;
+            }
+            value = (target + (1UL << (FILTER_FRAC_BITS - 1))) >> FILTER_FRAC_BITS;
+        }
+        uint32_t corrected = target;
+        if (alignFrames_)
+        {
+            // A frame elejere interpolalva; a median ezutan mar egy idopont mintait latja
+            target = alignSample(corrected, prevSampleQ16_[ch], sampleUs_[ch], prevSampleUs_[ch], frameUs);
+            value = (target + (1UL << (FILTER_FRAC_BITS - 1))) >> FILTER_FRAC_BITS;
+        }
+        // Kikapcsolt igazitasnal is: bekapcsolaskor az elozo korrigalt minta mar megvan
+        prevSampleQ16_[ch] = corrected;
+        prevSampleUs_[ch] = sampleUs_[ch];
+        if (median_[ch].getWindow() > 1)
+        {
+            value = median_[ch](value);
+            target = static_cast<uint32_t>(value) << FILTER_FRAC_BITS;
+        }
+        if (decimationLog2_)
+        {
+            // A csatornak egyutt leptetnek: vagy mind, vagy egyik sem ad kimenetet
+            if (!cic_[ch].push(value))
+            {
+                continue;
+            }
+            target = cic_[ch].output();
+            decimated = true;
+        }
+        if (predictorMask_ & (1 << ch))
+        {
+            predictor_[ch].updateQ16(target);
+        }
+        if (autoTuneMask_ & (1 << ch))
+        {
+            noise_[ch].add(target);
+        }
+        // y += (x - y) / 2^K Q10.16-ban, elojeles shifttel; a tort resz nem vesz el
+        emaState_[ch] += static_cast<int32_t>(target - emaState_[ch]) >> emaShift_[ch];
+    }
+    // A prediktor a szurt minta idejetol szamol
+    if (!decimationLog2_ || decimated)
+    {
+        lastFrameUs_ = frameUs;
+    }
+    LATENCY_MARK(MARK_FILTER_END);
+}
+
+bool MCP3008Reader::setDecimation(uint8_t stages, uint8_t rateLog2, bool compensate)
+{
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        if (!cic_[ch].configure(stages, rateLog2, compensate))
+        {
+            return false;
+        }
+    }
+    decimationLog2_ = rateLog2;
+    return true;
+}
+
+void MCP3008Reader::setReferenceChannel(int8_t channel, uint16_t nominal)
+{
+    if (channel >= CHANNEL_NUMBER_ || nominal > MAX_ADC_VALUE)
+    {
+        return;
+    }
+    referenceChannel_ = channel < 0 ? -1 : channel;
+    referenceNominalQ8_ = static_cast<uint32_t>(nominal) << 8;
+    referenceLearned_ = nominal ? REFERENCE_LEARN_FRAMES : 0;
+    referenceSum_ = 0;
+    referenceGainQ16_ = 1UL << FILTER_FRAC_BITS;
+    referenceFaults_ = 0;
+    correctMask_ = 0;
+    if (referenceChannel_ >= 0)
+    {
+        correctMask_ = ((1 << CHANNEL_NUMBER_) - 1) & ~(1 << referenceChannel_);
+    }
+    updateReadOrder();
+}
+
+void MCP3008Reader::setAlignedFrames(bool enabled, bool alternateOrder)
+{
+    // Az elso igazitott frame az utolso frame korrigalt mintajahoz interpolal (readChannelsWithEMA)
+    alignFrames_ = enabled;
+    alternateOrder_ = alternateOrder;
+}
+
+void MCP3008Reader::setDifferential(uint8_t channel, bool enabled)
 {
+    if (channel >= CHANNEL_NUMBER_)
+    {
+        return;
+    }
+    if (enabled)
+    {
+        differentialMask_ |= 1 << channel;
+    }
+    else
+    {
+        differentialMask_ &= ~(1 << channel);
+    }
+}
+
+// A referencia a frame kozepere kerul: a legtavolabbi csatorna is csak fel frame-nyire van tole,
+// igy gyorsabb ripple is kiesik. A tobbi csatorna sorrendje marad.
+void MCP3008Reader::updateReadOrder()
+{
+    uint8_t middle = CHANNEL_NUMBER_ / 2;
+    uint8_t i = 0;
     for (uint8_t ch = 0; ch < CHANNEL_NUMBER_; ++ch)
     {
-        emaValues_[ch] = ema_[ch](adc_->readADC(ch));
+        if (referenceChannel_ >= 0 && i == middle)
+        {
+            readOrder_[i++] = referenceChannel_;
+        }
+        if (ch != referenceChannel_)
+        {
+            readOrder_[i++] = ch;
+        }
+    }
+}
+
+// Nevleges / mert referencia Q16-ban; a tanulas alatt es tartomanyon kivuli referencianal 1.0
+uint32_t MCP3008Reader::referenceGain()
+{
+    uint32_t reference = rawValues_[referenceChannel_];
+    if (referenceLearned_ < REFERENCE_LEARN_FRAMES)
+    {
+        referenceSum_ += reference;
+        if (++referenceLearned_ == REFERENCE_LEARN_FRAMES)
+        {
+            referenceNominalQ8_ = ((referenceSum_ << 8) + REFERENCE_LEARN_FRAMES / 2) / REFERENCE_LEARN_FRAMES;
+        }
+        return 1UL << FILTER_FRAC_BITS;
+    }
+    uint32_t referenceQ8 = reference << 8;
+    uint32_t tolerance = referenceNominalQ8_ >> REFERENCE_TOLERANCE_SHIFT;
+    if (reference == 0 || referenceQ8 + tolerance < referenceNominalQ8_ || referenceQ8 > referenceNominalQ8_ + tolerance)
+    {
+        // Szakadt vagy zarlatos oszto: inkabb korrekcio nelkul, mint hibas skalaval
+        referenceFaults_++;
+        referenceGainQ16_ = 1UL << FILTER_FRAC_BITS;
+        return referenceGainQ16_;
     }
+    // nominalQ8 < 2^18, igy a szamlalo < 2^26
+    referenceGainQ16_ = ((referenceNominalQ8_ << 8) + reference / 2) / reference;
+    return referenceGainQ16_;
+}
+
+void MCP3008Reader::setMedianWindow(uint8_t channel, uint8_t window)
+{
+    if (channel >= CHANNEL_NUMBER_)
+    {
+        return;
+    }
+    if (window > arraySize_)
+    {
+        window = arraySize_;
+    }
+    median_[channel].setWindow(window);
+}
+
+void MCP3008Reader::setPredictorEnabled(uint8_t channel, bool enabled)
+{
+    if (channel >= CHANNEL_NUMBER_)
+    {
+        return;
+    }
+    if (enabled)
+    {
+        // Az EMA aktualis ertekerol indul, igy nincs ugras a valtaskor
+        predictor_[channel].reset();
+        predictor_[channel].update(getEMAValues(channel));
+        predictorMask_ |= 1 << channel;
+    }
+    else
+    {
+        predictorMask_ &= ~(1 << channel);
+    }
+}
+
+void MCP3008Reader::setAutoTune(uint8_t channel, bool enabled)
+{
+    if (channel >= CHANNEL_NUMBER_)
+    {
+        return;
+    }
+    if (enabled)
+    {
+        noise_[channel].reset();
+        autoTuneMask_ |= 1 << channel;
+    }
+    else
+    {
+        autoTuneMask_ &= ~(1 << channel);
+        setEmaShift(channel, EMA_SHIFT);
+    }
+}
+
+void MCP3008Reader::setEmaShift(uint8_t channel, uint8_t shift)
+{
+    if (channel >= CHANNEL_NUMBER_ || shift == emaShift_[channel])
+    {
+        return;
+    }
+    // A Q10.16 allapot nem fugg a sulytol, a valtas ugras nelkuli
+    emaShift_[channel] = shift;
+    // A prediktor zaja kovesse az EMA-t (lebegopontos, ezert itt es nem az acquisition-ben)
+    predictor_[channel].matchEmaNoise(shift);
+}
+
+// HID count / ADC count erosites a linearis map-olasbol
+uint32_t MCP3008Reader::hidGain(uint8_t channel) const
+{
+    if (mapping_)
+    {
+        // t = (u * scale) >> 15 Q10.8 bemenetre: countonkent scale / 128 a 65536-os tartomanybol
+        return (mapping_->channels[channel].scale + 64) >> 7;
+    }
+    uint32_t range = channelMinMaxValues_[channel].maxValue - channelMinMaxValues_[channel].minValue;
+    return range ? 65536UL / range : 0;
+}
+
+void MCP3008Reader::updateFilterTuning()
+{
+    for (uint8_t ch = 0; ch < CHANNEL_NUMBER_; ++ch)
+    {
+        if (!(autoTuneMask_ & (1 << ch)) || !noise_[ch].process() || !noise_[ch].hasEstimate())
+        {
+            continue;
+        }
+        // EMA kimeneti variancia: var * a / (2 - a), a = 2^-k, azaz var / (2^(k+1) - 1).
+        // A legkisebb k, amire var * gain^2 / (2^(k+1) - 1) <= target^2
+        uint64_t gain = hidGain(ch);
+        uint64_t needed = (static_cast<uint64_t>(noise_[ch].varianceQ8()) * gain * gain) >> 8;
+        uint64_t target = static_cast<uint64_t>(jitterTargetHid_) * jitterTargetHid_;
+        uint8_t shift = EMA_MIN_SHIFT;
+        while (shift < EMA_MAX_SHIFT && ((2ULL << shift) - 1) * target < needed)
+        {
+            shift++;
+        }
+        setEmaShift(ch, shift);
+    }
+}
+
+void MCP3008Reader::setPredictionTiming(uint32_t samplePeriodUs, uint32_t pollLeadUs)
+{
+    samplePeriodUs_ = samplePeriodUs ? samplePeriodUs : 1;
+    pollLeadUs_ = pollLeadUs;
+}
+
+uint32_t MCP3008Reader::getPredictedValue(uint8_t channel)
+{
+    // A minta kora + a host pollig hatralevo ido, mintaban (Q8)
+    uint32_t leadUs = (micros() - lastFrameUs_) + pollLeadUs_;
+    if (leadUs > 0xFFFF)
+    {
+        leadUs = 0xFFFF; // a predict() ugyis korlatoz, igy 32 biten marad az osztas
+    }
+    uint32_t leadQ8 = (leadUs << 8) / samplePeriodUs_;
+    return predictor_[channel].predict(leadQ8);
 }
 
 uint32_t MCP3008Reader::getEMAValues(uint8_t channel) {
-    return emaValues_[channel];
+    return (emaState_[channel] + (1UL << (FILTER_FRAC_BITS - 1))) >> FILTER_FRAC_BITS;
 }
 
 // Map-olt joystick adatok lekerese az adott csatornarol
 int16_t MCP3008Reader::getMappedJoystickValue(uint8_t channel) {
     //int16_t rawValue = getMedianValue(channel);
-    uint32_t rawValue = getEMAValues(channel);
-    if (channel >= CHANNEL_NUMBER_ || !channelMinMaxValues_[channel].isActive) {
-        return 0; // Hibakezelés: érvénytelen csatorna vagy inaktív csatorna esetén 0-t ad vissza
-    }
-    // Az ertek map-olasa a joystick ertekek tartomanyara
-    //if(rawValue < channelMinMaxValues_[channel].minValue) rawValue = channelMinMaxValues_[channel].minValue;
-    //if(rawValue > channelMinMaxValues_[channel].maxValue) rawValue = channelMinMaxValues_[channel].maxValue;
-    rawValue = constrain(rawValue, channelMinMaxValues_[channel].minValue, channelMinMaxValues_[channel].maxValue);
-    if(channelMinMaxValues_[channel].isInverted) {
-        // Invertált esetben fordítva map-oljuk
-        return map(rawValue, channelMinMaxValues_[channel].maxValue, channelMinMaxValues_[channel].minValue, JOYSTICK_MIN_VALUE, JOYSTICK_MAX_VALUE);
-    }
-    // Normál esetben simán map-oljuk
-    return map(rawValue, channelMinMaxValues_[channel].minValue, channelMinMaxValues_[channel].maxValue, JOYSTICK_MIN_VALUE, JOYSTICK_MAX_VALUE);
+    if (channel >= CHANNEL_NUMBER_) {
+        return 0;
+    }
+    uint32_t filtered = isPredictorEnabled(channel) ? getPredictedValue(channel) : getFilteredQ16(channel);
+    if (mapping_) {
+        // Profil tabla: skala + gorbe LUT, az inaktiv csatorna 0-t ad
+        return mapping_->channels[channel].apply(filtered);
+    }
+    // Inaktív csatorna esetén 0
+    return mapLinear(channelMinMaxValues_[channel], filtered);
 }
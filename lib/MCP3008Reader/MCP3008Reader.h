@@ -7,10 +7,20 @@
 #include <vector>
 //#include <algorithm> // sort, max_element
 #include <Adafruit_MCP3008.h>
-#include <EMA.h>
+#include <RunningMedian.h>
+#include <MappingProfile.h>
+#include <AxisPredictor.h>
+#include <NoiseEstimator.h>
+#include <CicDecimator.h>
 
 const int MAX_ADC_VALUE = 1023; // Maximum ADC value for MCP3008
+const uint8_t EMA_SHIFT = 8; // EMA sulya 1/2^EMA_SHIFT
+const uint8_t FILTER_FRAC_BITS = 16; // szurt ertekek Q10.16 formatumban
+const uint8_t EMA_MIN_SHIFT = 2;  // automatikus hangolas: legkonnyebb szures
+const uint8_t EMA_MAX_SHIFT = 10; // automatikus hangolas: legerosebb szures
 const int CHANNEL_COUNT = 8; // Total number of channels
+const uint16_t REFERENCE_LEARN_FRAMES = 256;  // referencia nevleges erteke ennyi frame atlagabol
+const uint8_t REFERENCE_TOLERANCE_SHIFT = 2;  // +-1/4 nevlegestol eltero referencia: nincs korrekcio
 
 const int JOYSTICK_MIN_VALUE = -32767; // Minimum joystick value
 const int JOYSTICK_MAX_VALUE = 32767;  // Maximum joystick value
@@ -32,7 +42,7 @@ struct channelMixMaxValues
     bool isActive = true;  // Alapértelmezés szerint aktív
 };
 
-const channelMixMaxValues channelMinMaxValues_[] = {
+constexpr channelMixMaxValues channelMinMaxValues_[] = {
     {360, 631, true, true}, // CHANNEL_THROTTLE_LEFT
     {273, 767, false, true},  // CHANNEL_THROTTLE_RIGHT
     {275, 783, false, true}, // CHANNEL_RUDDER
@@ -57,18 +67,172 @@ public:
   // Map-olt joystick adatok lekerese az adott csatornarol
   int16_t getMappedJoystickValue(uint8_t channel);
 
+  // Ugyanaz forditasi ideju csatornaval (AxisRouting): nincs hatarellenorzes, az inaktiv
+  // csatorna es a tartomany konstans; PREDICTED = prediktor, ha a csatornan be van kapcsolva
+  template <uint8_t CH, bool PREDICTED>
+  inline int16_t mappedValue()
+  {
+    static_assert(CH < CHANNEL_COUNT, "channel out of range");
+    uint32_t filtered = (PREDICTED && (predictorMask_ & (1 << CH))) ? getPredictedValue(CH) : emaState_[CH];
+    if (mapping_)
+    {
+      return mapping_->channels[CH].apply(filtered);
+    }
+    return mapLinear(channelMinMaxValues_[CH], filtered);
+  }
+
   // EMA szurites alkalmazasa az osszes csatornara
   void readChannelsWithEMA();
 
-  // EMA ertek lekerese az adott csatornarol
+  // EMA ertek lekerese az adott csatornarol, egesz ADC countra kerekitve
   uint32_t getEMAValues(uint8_t channel);
 
+  // EMA ertek tort bitekkel (Q10.16), ez megy a map-olasba
+  uint32_t getFilteredQ16(uint8_t channel) const { return emaState_[channel]; }
+
+  // Utolso nyers ADC ertek az adott csatornarol
+  uint16_t getRawValue(uint8_t channel) const { return rawValues_[channel]; }
+
+  // Map-olo tabla (profil) beallitasa; nullptr eseten a channelMinMaxValues_ szerinti map()
+  void setMapping(const MappingTable *mapping) { mapping_ = mapping; }
+  const MappingTable *getMapping() const { return mapping_; }
+
+  // Median tuskeszuro ablak az EMA elott (1 = kikapcsolva, max. arraySize)
+  void setMedianWindow(uint8_t channel, uint8_t window);
+
+  // Alpha-beta prediktor a csatornan; bekapcsolva a map-olt ertek ebbol jon az EMA helyett
+  void setPredictorEnabled(uint8_t channel, bool enabled);
+  bool isPredictorEnabled(uint8_t channel) const { return (predictorMask_ >> channel) & 1; }
+  AxisPredictor &predictor(uint8_t channel) { return predictor_[channel]; }
+
+  // Automatikus EMA hangolas a nyugalmi zajbol: a legkisebb suly, amellyel a kimenet
+  // szorasa a cel alatt marad (HID countban)
+  void setAutoTune(uint8_t channel, bool enabled);
+  void setJitterTarget(uint16_t hidCounts) { jitterTargetHid_ = hidCounts ? hidCounts : 1; }
+
+  // Kesz zaj blokkok kiertekelese es hangolas; alacsony prioritasu taskbol hivando
+  void updateFilterTuning();
+
+  uint8_t getEmaShift(uint8_t channel) const { return emaShift_[channel]; }
+  void setEmaShift(uint8_t channel, uint8_t shift);
+  const NoiseEstimator &noise(uint8_t channel) const { return noise_[channel]; }
+
+  // Mintavetelezesi periodus es a host poll varhato kesese a report utan (extrapolacio)
+  void setPredictionTiming(uint32_t samplePeriodUs, uint32_t pollLeadUs);
+
+  // Prediktalt ertek a varhato host poll idopontjara (Q10.16)
+  uint32_t getPredictedValue(uint8_t channel);
+
+  // CIC decimalas a median utan, az EMA elott: az EMA, a prediktor es a zajbecsles
+  // 2^rateLog2 frame-enkent kap egy mintat. rateLog2 = 0 kikapcsolja.
+  bool setDecimation(uint8_t stages, uint8_t rateLog2, bool compensate);
+  uint8_t getDecimationLog2() const { return decimationLog2_; }
+
+  // Aranyos (ratiometrikus) korrekcio: a referencia csatornat (pl. oszto a potmeterek taprol)
+  // minden frame-ben a tobbi kozott, kozepen olvassa, es a tobbi csatornat nevleges / referencia
+  // aranyban korrigalja a median elott. nominal = 0: az elso REFERENCE_LEARN_FRAMES frame atlaga.
+  // channel < 0 kikapcsolja.
+  void setReferenceChannel(int8_t channel, uint16_t nominal = 0);
+  int8_t getReferenceChannel() const { return referenceChannel_; }
+  uint32_t getReferenceNominalQ8() const { return referenceNominalQ8_; }
+  uint32_t getReferenceGainQ16() const { return referenceGainQ16_; }
+  uint32_t getReferenceFaults() const { return referenceFaults_; }
+
+  // Igazitott frame: minden csatorna mintajat linearis interpolacioval a frame elejere (az elso
+  // olvasas idejere) viszi az elozo mintajabol, igy a csatornak kozotti kombinaciok egy pillanatot
+  // latnak. alternateOrder: minden masodik frame forditott sorrendben olvas (a kesesi bias kiesik).
+  void setAlignedFrames(bool enabled, bool alternateOrder);
+  bool isAlignedFrames() const { return alignFrames_; }
+  bool isAlternateOrder() const { return alternateOrder_; }
+
+  // Az utolso frame csatornankenti mintavetelezesi ideje (micros)
+  uint32_t getSampleUs(uint8_t channel) const { return sampleUs_[channel]; }
+  uint32_t getFrameUs() const { return frameUs_; }
+
+  // Minta (Q10.16, nowUs-kor) a korabbi frameUs idopontra, az elozo mintabol (prevUs) interpolalva.
+  // Tul hosszu vagy nulla kozre (kimaradt frame-ek, elso minta) a minta valtozatlan.
+  static inline uint32_t alignSample(uint32_t nowQ16, uint32_t prevQ16, uint32_t nowUs, uint32_t prevUs,
+                                     uint32_t frameUs)
+  {
+    uint32_t span = nowUs - prevUs;
+    uint32_t lag = nowUs - frameUs;
+    if (span == 0 || span > 0xFFFF || lag == 0)
+    {
+      return nowQ16;
+    }
+    if (lag > span)
+    {
+      lag = span;
+    }
+    // Q16 suly 32 bites osztassal (RP2040 hardver oszto), a szorzat 64 biten
+    int32_t weight = (lag << 16) / span;
+    int32_t delta = static_cast<int32_t>(nowQ16 - prevQ16);
+    return nowQ16 - static_cast<int32_t>((static_cast<int64_t>(delta) * weight) >> 16);
+  }
+
+  // Pseudo-differencialis olvasas: a csatorna az IN+, a parja (channel ^ 1) az IN- (pl. a
+  // potmeterek fold visszavezetese). A par ettol meg olvashato egyedul is.
+  void setDifferential(uint8_t channel, bool enabled);
+  bool isDifferential(uint8_t channel) const { return (differentialMask_ >> channel) & 1; }
+
 private:
+  uint32_t hidGain(uint8_t channel) const;
+  uint32_t referenceGain();
+  void updateReadOrder();
+
+  // Profil tabla nelkuli linearis map-oles Q10.8-ban, hogy a tort resz megmaradjon
+  static inline int16_t mapLinear(const channelMixMaxValues &limits, uint32_t filteredQ16)
+  {
+    if (!limits.isActive)
+    {
+      return 0;
+    }
+    int32_t minQ8 = limits.minValue << 8;
+    int32_t maxQ8 = limits.maxValue << 8;
+    int32_t value = static_cast<int32_t>(filteredQ16 >> 8);
+    value = value < minQ8 ? minQ8 : (value > maxQ8 ? maxQ8 : value);
+    // Invertált esetben fordítva map-oljuk
+    int32_t offset = limits.isInverted ? maxQ8 - value : value - minQ8;
+    int64_t span = JOYSTICK_MAX_VALUE - JOYSTICK_MIN_VALUE;
+    return JOYSTICK_MIN_VALUE + static_cast<int32_t>(offset * span / (maxQ8 - minQ8));
+  }
+
   uint8_t arraySize_;
   uint8_t CHANNEL_NUMBER_;
   Adafruit_MCP3008* adc_;
-  EMA<8, uint32_t> ema_[CHANNEL_COUNT]; // EMA szűrők minden csatornához
-  uint32_t emaValues_[CHANNEL_COUNT] = {0}; // EMA értékek tárolása minden csatornához
+  // EMA allapot csatornankent, Q10.16; a tort resz nem vesz el, nem ragad be egy counttal a cel alatt
+  uint32_t emaState_[CHANNEL_COUNT] = {0};
+  uint16_t rawValues_[CHANNEL_COUNT] = {0}; // utolso nyers ADC ertekek
+  bool emaSeeded_ = false; // az elso minta inditja az EMA-t, nem 0-rol kuszik fel
+  RunningMedian median_[CHANNEL_COUNT]; // median szurok a tuskek ellen
+  const MappingTable *mapping_ = nullptr; // aktiv profil tablaja
+  AxisPredictor predictor_[CHANNEL_COUNT];
+  uint8_t emaShift_[CHANNEL_COUNT];        // EMA suly csatornankent, 1/2^shift
+  NoiseEstimator noise_[CHANNEL_COUNT];
+  uint8_t autoTuneMask_ = 0;               // hangolt csatornak
+  uint16_t jitterTargetHid_ = 16;
+  uint8_t predictorMask_ = 0;       // bekapcsolt prediktorok csatornankent
+  uint32_t lastFrameUs_ = 0;        // utolso frame kezdete
+  uint32_t samplePeriodUs_ = 500;
+  uint32_t pollLeadUs_ = 500;       // fel USB poll intervallum
+  CicDecimator cic_[CHANNEL_COUNT];
+  uint8_t decimationLog2_ = 0;      // 0: minden frame megy az EMA-ba
+  uint8_t readOrder_[CHANNEL_COUNT];  // olvasasi sorrend; a referencia a frame kozepen
+  uint8_t differentialMask_ = 0;    // pseudo-differencialis csatornak
+  uint8_t correctMask_ = 0;         // aranyosan korrigalt csatornak
+  int8_t referenceChannel_ = -1;
+  uint16_t referenceLearned_ = 0;   // eddig atlagolt frame-ek
+  uint32_t referenceSum_ = 0;
+  uint32_t referenceNominalQ8_ = 0; // nevleges referencia, Q10.8
+  uint32_t referenceGainQ16_ = 1UL << FILTER_FRAC_BITS;
+  uint32_t referenceFaults_ = 0;    // tartomanyon kivuli referencia mintak
+  uint32_t frameUs_ = 0;            // utolso frame eleje (az igazitas idopontja)
+  uint32_t sampleUs_[CHANNEL_COUNT] = {0};     // csatornankenti mintavetel ideje
+  uint32_t prevSampleUs_[CHANNEL_COUNT] = {0}; // az elozo minta ideje (igazitas)
+  uint32_t prevSampleQ16_[CHANNEL_COUNT] = {0}; // az elozo (korrigalt) minta, Q10.16
+  bool alignFrames_ = false;
+  bool alternateOrder_ = false;
+  bool reverseFrame_ = false;       // ez a frame forditott sorrendben olvas
 };
 
 #endif // MCP3008READER_H
\ No newline at end of file
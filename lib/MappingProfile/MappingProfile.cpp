@@ -0,0 +1,264 @@
+#include <MappingProfile.h>
+#include <string.h>
+
+static const uint16_t PROFILE_MAGIC = 0x4A50; // "PJ"
+static const uint8_t PROFILE_VERSION = 1;
+
+static int16_t constrainAxis(int32_t value)
+{
+    if (value < -32767) return -32767;
+    if (value > 32767) return 32767;
+    return static_cast<int16_t>(value);
+}
+
+static uint16_t recordAddress(uint8_t index)
+{
+    return PROFILE_STORE_ADDRESS + sizeof(ProfileStoreHeader) +
+           index * (sizeof(MappingProfile) + sizeof(uint16_t));
+}
+
+ProfileManager::ProfileManager(const MappingProfile &defaults)
+    : current_(nullptr), readerEpoch_(0), version_(0), currentIndex_(0), staleMask_(0)
+{
+    for (uint8_t i = 0; i < PROFILE_COUNT; ++i)
+    {
+        profiles_[i] = defaults;
+        profileSlot_[i] = -1;
+    }
+    for (uint8_t i = 0; i < MAPPING_TABLE_SLOTS; ++i)
+    {
+        slotState_[i] = SLOT_FREE;
+        retireEpoch_[i] = 0;
+    }
+    rebuild(0, true);
+}
+
+void ProfileManager::buildTable(const MappingProfile &profile, MappingTable &table)
+{
+    const int32_t half = 32767;
+    for (uint8_t ch = 0; ch < PROFILE_CHANNELS; ++ch)
+    {
+        const ChannelProfile &cp = profile.channels[ch];
+        ChannelMap &map = table.channels[ch];
+
+        uint32_t maxValue = cp.maxValue > cp.minValue ? cp.maxValue : cp.minValue + 1;
+        map.minQ8 = static_cast<uint32_t>(cp.minValue) << 8;
+        map.maxQ8 = maxValue << 8;
+        // Felfele kerekitve, hogy maxValue pontosan az utolso LUT pontra essen
+        uint32_t range = maxValue - cp.minValue;
+        map.scale = ((65536UL << 7) + range - 1) / range;
+
+        bool active = cp.flags & PROFILE_FLAG_ACTIVE;
+        bool inverted = cp.flags & PROFILE_FLAG_INVERTED;
+        float deadzone = cp.deadzone / 1000.0f; // fel-szelesseg a [-1, 1] tartomanyban
+        float expo = cp.expo / 100.0f;
+
+        for (uint8_t i = 0; i <= CURVE_SEGMENTS; ++i)
+        {
+            if (!active)
+            {
+                map.curve[i] = 0;
+                continue;
+            }
+
+            // x a [-1, 1] tartomanyban, holtsav, majd expo gorbe
+            float x = (2.0f * i) / CURVE_SEGMENTS - 1.0f;
+            if (inverted)
+            {
+                x = -x;
+            }
+            float ax = x < 0 ? -x : x;
+            ax = ax <= deadzone ? 0.0f : (ax - deadzone) / (1.0f - deadzone);
+            float y = (1.0f - expo) * ax + expo * ax * ax * ax;
+            if (x < 0)
+            {
+                y = -y;
+            }
+
+            int32_t value = static_cast<int32_t>(y * half + (y < 0 ? -0.5f : 0.5f));
+            map.curve[i] = constrainAxis(value);
+        }
+    }
+}
+
+void ProfileManager::load(Storage *storage)
+{
+    if (storage == nullptr || !storage->isAvailable())
+    {
+        return;
+    }
+
+    ProfileStoreHeader header;
+    if (!storage->read(PROFILE_STORE_ADDRESS, &header, sizeof(header)) ||
+        header.magic != PROFILE_MAGIC || header.version != PROFILE_VERSION)
+    {
+        return; // nincs mentett profil, maradnak az alapertelmezettek
+    }
+
+    for (uint8_t i = 0; i < PROFILE_COUNT && i < header.count; ++i)
+    {
+        MappingProfile profile;
+        uint16_t crc;
+        uint16_t address = recordAddress(i);
+        if (storage->read(address, &profile, sizeof(profile)) &&
+            storage->read(address + sizeof(profile), &crc, sizeof(crc)) &&
+            crc == storageCrc16(&profile, sizeof(profile)))
+        {
+            profile.name[PROFILE_NAME_LENGTH - 1] = '\0';
+            profiles_[i] = profile;
+            if (i != currentIndex_)
+            {
+                drop(i); // a tobbi az elso hasznalatkor epul
+            }
+        }
+    }
+    // Az aktiv profil tablaja azonnal, uj snapshotkent
+    rebuild(currentIndex_, true);
+}
+
+bool ProfileManager::save(Storage *storage, uint8_t index)
+{
+    if (storage == nullptr || index >= PROFILE_COUNT || !storage->isAvailable())
+    {
+        return false;
+    }
+
+    ProfileStoreHeader header = {PROFILE_MAGIC, PROFILE_VERSION, PROFILE_COUNT};
+    uint16_t crc = storageCrc16(&profiles_[index], sizeof(MappingProfile));
+    uint16_t address = recordAddress(index);
+    return storage->write(PROFILE_STORE_ADDRESS, &header, sizeof(header)) &&
+           storage->write(address, &profiles_[index], sizeof(MappingProfile)) &&
+           storage->write(address + sizeof(MappingProfile), &crc, sizeof(crc));
+}
+
+bool ProfileManager::select(uint8_t index)
+{
+    if (index >= PROFILE_COUNT)
+    {
+        return false;
+    }
+    bool stale = staleMask_ & (1 << index);
+    if ((profileSlot_[index] < 0 || stale) && !rebuild(index, false))
+    {
+        return false;
+    }
+    currentIndex_ = index;
+    publish(profileSlot_[index]);
+    return true;
+}
+
+bool ProfileManager::setProfile(uint8_t index, const MappingProfile &profile)
+{
+    if (index >= PROFILE_COUNT)
+    {
+        return false;
+    }
+    profiles_[index] = profile;
+    if (index != currentIndex_)
+    {
+        drop(index);
+        return true;
+    }
+    if (!rebuild(index, true))
+    {
+        // A publikalt tabla marad, a kovetkezo select() ujraepiti
+        staleMask_ |= 1 << index;
+        return false;
+    }
+    return true;
+}
+
+const MappingTable *ProfileManager::acquire()
+{
+    // Nyugalmi pont: az elozo acquire() ota betoltott snapshotot mar nem hasznaljuk.
+    // Csak az olvaso irja, ezert eleg egy sima (nem RMW) atomi tarolas.
+    __atomic_store_n(&readerEpoch_, readerEpoch_ + 1, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&current_, __ATOMIC_SEQ_CST);
+}
+
+uint8_t ProfileManager::retiredCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MAPPING_TABLE_SLOTS; ++i)
+    {
+        if (slotState_[i] == SLOT_RETIRED)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Uj snapshot a profilbol egy szabad slotba; a profil regi tablaja a publikalas utan visszatartva
+bool ProfileManager::rebuild(uint8_t index, bool publishNow)
+{
+    reclaim();
+    int8_t slot = freeSlot();
+    if (slot < 0)
+    {
+        return false;
+    }
+    buildTable(profiles_[index], tables_[slot]);
+    tables_[slot].version = ++version_;
+    slotState_[slot] = SLOT_CACHED;
+    staleMask_ &= ~(1 << index);
+
+    int8_t old = profileSlot_[index];
+    profileSlot_[index] = slot;
+    if (publishNow)
+    {
+        publish(slot);
+    }
+    if (old >= 0)
+    {
+        // Csak a publikalas utan: az olvaso a regit a kovetkezo nyugalmi pontig meg hasznalhatja
+        retire(old);
+    }
+    return true;
+}
+
+// A profil tablaja elavult; az olvaso meg tarthatja (pl. epp valtottunk rola)
+void ProfileManager::drop(uint8_t index)
+{
+    if (profileSlot_[index] >= 0)
+    {
+        retire(profileSlot_[index]);
+        profileSlot_[index] = -1;
+    }
+}
+
+void ProfileManager::publish(int8_t slot)
+{
+    __atomic_store_n(&current_, &tables_[slot], __ATOMIC_SEQ_CST);
+}
+
+void ProfileManager::retire(int8_t slot)
+{
+    slotState_[slot] = SLOT_RETIRED;
+    retireEpoch_[slot] = __atomic_load_n(&readerEpoch_, __ATOMIC_SEQ_CST);
+}
+
+// Visszatartott slotok felszabaditasa, ha az olvaso azota atlepett egy nyugalmi ponton
+void ProfileManager::reclaim()
+{
+    uint32_t epoch = __atomic_load_n(&readerEpoch_, __ATOMIC_SEQ_CST);
+    for (uint8_t i = 0; i < MAPPING_TABLE_SLOTS; ++i)
+    {
+        if (slotState_[i] == SLOT_RETIRED && static_cast<int32_t>(epoch - retireEpoch_[i]) > 0)
+        {
+            slotState_[i] = SLOT_FREE;
+        }
+    }
+}
+
+int8_t ProfileManager::freeSlot() const
+{
+    for (uint8_t i = 0; i < MAPPING_TABLE_SLOTS; ++i)
+    {
+        if (slotState_[i] == SLOT_FREE)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
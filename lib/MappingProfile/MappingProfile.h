@@ -0,0 +1,151 @@
+#ifndef MAPPINGPROFILE_H
+#define MAPPINGPROFILE_H
+
+#include <stdint.h>
+#include <Storage.h>
+
+const uint8_t PROFILE_CHANNELS = 8;       // MCP3008 csatornak
+const uint8_t PROFILE_COUNT = 4;          // tarolt profilok szama
+const uint8_t PROFILE_NAME_LENGTH = 12;   // nev hossza lezaro nullaval
+const uint8_t CURVE_SEGMENTS = 32;        // gorbe LUT szakaszok
+const uint8_t CURVE_SEGMENT_BITS = 11;    // 65536 / 32 = 2^11
+const uint8_t MAPPING_TABLE_SLOTS = PROFILE_COUNT + 2; // profilonkent egy + 2 a csere es visszatartas idejere
+
+const uint8_t PROFILE_FLAG_INVERTED = 0x01;
+const uint8_t PROFILE_FLAG_ACTIVE = 0x02;
+
+// Csatorna beallitasai, igy tarolodnak az EEPROM-ban
+struct ChannelProfile
+{
+  uint16_t minValue;  // ADC also hatar
+  uint16_t maxValue;  // ADC felso hatar
+  uint8_t flags;      // PROFILE_FLAG_*
+  uint8_t deadzone;   // kozepso holtsav a teljes tartomany ezrelekeben (0..255 -> 0..25.5%)
+  int8_t expo;        // gorbe -100..100, 0 = linearis
+  uint8_t reserved;
+};
+
+struct MappingProfile
+{
+  char name[PROFILE_NAME_LENGTH];
+  ChannelProfile channels[PROFILE_CHANNELS];
+};
+
+// EEPROM elrendezes: fejlec, utana PROFILE_COUNT db rekord (profil + CRC16)
+struct ProfileStoreHeader
+{
+  uint16_t magic;
+  uint8_t version;
+  uint8_t count;
+};
+
+const uint16_t PROFILE_STORE_ADDRESS = 0x0040;
+const uint16_t PROFILE_STORE_END = PROFILE_STORE_ADDRESS + sizeof(ProfileStoreHeader) +
+                                   PROFILE_COUNT * (sizeof(MappingProfile) + sizeof(uint16_t));
+
+// Csatornankent elore kiszamolt map-oles: skala es gorbe LUT
+struct ChannelMap
+{
+  uint32_t minQ8;                       // ADC also hatar, Q10.8
+  uint32_t maxQ8;                       // ADC felso hatar, Q10.8
+  uint32_t scale;                       // ceil((65536 << 7) / (max - min)), Q10.8 bemenethez
+  int16_t curve[CURVE_SEGMENTS + 1];    // kimenet a tartomany 33 pontjaban
+
+  // Szurt ADC ertek (Q10.16) -> joystick ertek, elagazas nelkul az inaktiv csatornakra is (csupa 0 LUT).
+  // A tort bitek megmaradnak, igy szuk tartomanynal sem lepcsozik a kimenet.
+  inline int16_t apply(uint32_t valueQ16) const
+  {
+    uint32_t v = valueQ16 >> 8;
+    if (v < minQ8) v = minQ8;
+    if (v > maxQ8) v = maxQ8;
+    uint32_t t = ((v - minQ8) * scale) >> 15; // 0..65536, a szorzat < 2^32
+    uint32_t seg = t >> CURVE_SEGMENT_BITS;
+    if (seg >= CURVE_SEGMENTS)
+    {
+      return curve[CURVE_SEGMENTS];
+    }
+    int32_t frac = t & ((1UL << CURVE_SEGMENT_BITS) - 1);
+    int32_t a = curve[seg];
+    int32_t b = curve[seg + 1];
+    return a + (((b - a) * frac) >> CURVE_SEGMENT_BITS);
+  }
+};
+
+// Egy publikalt snapshot; publikalas utan soha nem irodik felul, csak a visszatartas lejarta utan ujrahasznositva
+struct MappingTable
+{
+  uint32_t version;                     // snapshot sorszam, minden ujraepiteskor no
+  ChannelMap channels[PROFILE_CHANNELS];
+};
+
+//
+// ProfileManager Class
+// Keeps PROFILE_COUNT named profiles and their derived MappingTables in RAM.
+// Tables are immutable snapshots in a small slot pool. An update builds a
+// new snapshot in a free slot and publishes it with a single pointer store
+// (RCU style); the replaced snapshot is retired and its slot reused only
+// after the reader has passed a quiescent point, i.e. called acquire()
+// again. The reader takes no lock and never allocates. One reader context
+// (the report task) is supported; writers must not run concurrently.
+//
+class ProfileManager {
+public:
+  ProfileManager(const MappingProfile &defaults);
+
+  // Profilok betoltese a tarolobol; ervenytelen rekord helyett az alapertelmezett
+  void load(Storage *storage);
+
+  // Profil mentese a tarolora
+  bool save(Storage *storage, uint8_t index);
+
+  // Profil valtas; a tablat szukseg eseten itt szamolja ki, nem a frame-ben.
+  // false, ha nincs szabad slot (az olvaso meg nem ert nyugalmi pontra)
+  bool select(uint8_t index);
+
+  // Olvaso oldal, frame elejen egyszer: nyugalmi pont (az elozo snapshotot mar nem hasznalja),
+  // majd az aktualis snapshot. A kovetkezo acquire()-ig ervenyes.
+  const MappingTable *acquire();
+
+  // Az aktualis snapshot, nyugalmi pont nelkul (diagnosztika)
+  const MappingTable *current() const { return __atomic_load_n(&current_, __ATOMIC_ACQUIRE); }
+  uint8_t currentIndex() const { return currentIndex_; }
+
+  const MappingProfile &profile(uint8_t index) const { return profiles_[index]; }
+
+  // Profil modositasa; az aktiv profilnal az uj snapshot azonnal publikalodik.
+  // false, ha nincs szabad slot; ekkor a profil elmentve, a tabla a kovetkezo select()-kor epul
+  bool setProfile(uint8_t index, const MappingProfile &profile);
+
+  // Visszatartott (meg nem ujrahasznosithato) snapshotok szama
+  uint8_t retiredCount() const;
+
+  static void buildTable(const MappingProfile &profile, MappingTable &table);
+
+private:
+  enum SlotState : uint8_t
+  {
+    SLOT_FREE,
+    SLOT_CACHED,  // egy profil kesz tablaja
+    SLOT_RETIRED  // az olvaso meg hasznalhatja
+  };
+
+  bool rebuild(uint8_t index, bool publishNow);
+  void drop(uint8_t index);
+  void publish(int8_t slot);
+  void retire(int8_t slot);
+  void reclaim();
+  int8_t freeSlot() const;
+
+  MappingProfile profiles_[PROFILE_COUNT];
+  MappingTable tables_[MAPPING_TABLE_SLOTS];
+  int8_t profileSlot_[PROFILE_COUNT];           // -1 = meg nincs tabla
+  SlotState slotState_[MAPPING_TABLE_SLOTS];
+  uint32_t retireEpoch_[MAPPING_TABLE_SLOTS];   // az olvaso epoch-ja a visszavonaskor
+  const MappingTable *current_;                 // csak __atomic muveletekkel
+  uint32_t readerEpoch_;                        // csak az olvaso irja
+  uint32_t version_;
+  uint8_t currentIndex_;
+  uint8_t staleMask_;                           // elavult, de publikalt tabla miatt meg le nem cserelt profilok
+};
+
+#endif // MAPPINGPROFILE_H
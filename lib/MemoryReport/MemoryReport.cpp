@@ -0,0 +1,88 @@
+#include <MemoryReport.h>
+#include <malloc.h>
+#ifdef ARDUINO_ARCH_MBED_RP2040
+#include <cmsis_os2.h>
+#include <rtx_os.h>
+#endif
+
+// Cimek egeszkent: a festes a sajat keretunkon kivul esik, nem lokalis valtozora mutat
+static uintptr_t paintBottom = 0; // a festett tartomany alja
+static uintptr_t paintTop = 0;    // a festett tartomany teteje
+static uintptr_t threadStackTop = 0;
+static uint32_t threadStackSize = 0;
+
+void __attribute__((noinline)) paintStack()
+{
+#ifdef ARDUINO_ARCH_MBED_RP2040
+    // A hivo szal (setup() alatt az mbed main thread) stackje az RTX leirobol
+    const osRtxThread_t *thread = static_cast<const osRtxThread_t *>(osThreadGetId());
+    if (thread == nullptr || thread->stack_mem == nullptr)
+    {
+        return;
+    }
+    uintptr_t base = reinterpret_cast<uintptr_t>(thread->stack_mem);
+    uintptr_t frame = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+    if (frame < base + STACK_PAINT_GUARD + STACK_PAINT_MARGIN || frame > base + thread->stack_size)
+    {
+        return; // nem ennek a szalnak a stackjen futunk
+    }
+    threadStackTop = base + thread->stack_size;
+    threadStackSize = thread->stack_size;
+    // Csak a meg nem hasznalt resz: a keretunk alatt egy kivetel keretnyi hely marad
+    paintBottom = base + STACK_PAINT_GUARD;
+    paintTop = frame - STACK_PAINT_MARGIN;
+    for (uintptr_t p = paintBottom; p < paintTop; ++p)
+    {
+        *reinterpret_cast<volatile uint8_t *>(p) = STACK_PAINT_PATTERN;
+    }
+#endif
+}
+
+uint32_t stackHighWaterMark()
+{
+    if (paintTop == 0)
+    {
+        return 0;
+    }
+    // Lentrol felfele az elso felulirt bajt a legmelyebb hasznalt pont
+    uintptr_t p = paintBottom;
+    while (p < paintTop && *reinterpret_cast<const volatile uint8_t *>(p) == STACK_PAINT_PATTERN)
+    {
+        ++p;
+    }
+    return threadStackTop - p;
+}
+
+uint32_t stackSize()
+{
+    return threadStackSize;
+}
+
+// glibc 2.33 ota a mallinfo() elavult (int mezok); newlib-ben csak mallinfo() van
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define HEAP_INFO mallinfo2
+#else
+#define HEAP_INFO mallinfo
+#endif
+
+uint32_t heapUsed()
+{
+    return HEAP_INFO().uordblks;
+}
+
+uint32_t heapArena()
+{
+    return HEAP_INFO().arena;
+}
+
+void printMemoryReport(Print &out)
+{
+    out.print("#MEM,stack_high_water,");
+    out.print(stackHighWaterMark());
+    out.print(',');
+    out.println(stackSize());
+    out.print("#MEM,heap_used,");
+    out.print(heapUsed());
+    out.print(',');
+    out.println(heapArena());
+}
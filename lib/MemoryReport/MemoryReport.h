@@ -0,0 +1,43 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// Hot path fuggvenyek RAM-ba helyezese (.time_critical, SRAM-bol fut, nincs XIP cache miss).
+// A readChannelsWithEMA() es a frame-enkent hivott sajat fuggvenyek (median, CIC, prediktor);
+// az Adafruit readADC() es az mbed SPI a flash-ben marad, ott az SPI atvitel a meghatarozo
+#ifdef ARDUINO_ARCH_MBED_RP2040
+#define RAM_FUNC(tag) __attribute__((noinline, section(".time_critical." tag)))
+#else
+#define RAM_FUNC(tag)
+#endif
+
+const uint8_t STACK_PAINT_MARGIN = 64;  // a paintStack() kerete alatt kihagyva (kivetel keret)
+const uint8_t STACK_PAINT_GUARD = 8;    // a stack aljan kihagyva (RTX tulcsordulas-jelzo szo)
+const uint8_t STACK_PAINT_PATTERN = 0xA5;
+
+//
+// MemoryReport
+// Runtime half of the memory budget report (the static per-module part is
+// printed at build time by scripts/memory_report.py): stack high-water mark
+// of the calling thread, by painting its still unused stack between the
+// bottom (from the RTX thread descriptor) and the caller's frame, and heap
+// usage from mallinfo(). Without an RTOS thread (sim) nothing is painted.
+//
+
+// A hivo szal stackjenek festese; setup() elejen kell hivni
+void paintStack();
+
+// A szal stackjebol eddig felhasznalt legnagyobb melyseg bajtban (a tetejetol), es a stack merete
+uint32_t stackHighWaterMark();
+uint32_t stackSize();
+
+// Foglalt heap bajtok es a heap teljes merete (arena)
+uint32_t heapUsed();
+uint32_t heapArena();
+
+// "#MEM," sorok kiirasa
+void printMemoryReport(Print &out);
+
+#endif // MEMORYREPORT_H
@@ -0,0 +1,66 @@
+#include <NoiseEstimator.h>
+
+NoiseEstimator::NoiseEstimator()
+{
+    reset();
+}
+
+void NoiseEstimator::startBlock()
+{
+    block_.sum = 0;
+    block_.sumSquares = 0;
+    block_.min = 0xFFFF;
+    block_.max = 0;
+    block_.count = 0;
+}
+
+void NoiseEstimator::reset()
+{
+    startBlock();
+    readyValid_ = false;
+    havePrevious_ = false;
+    previousMeanQ8_ = 0;
+    varianceQ8_ = 0;
+    restBlocks_ = 0;
+    movingBlocks_ = 0;
+}
+
+bool NoiseEstimator::process()
+{
+    if (!readyValid_)
+    {
+        return false;
+    }
+    NoiseBlock block = ready_;
+    readyValid_ = false;
+
+    // var = (n * sum(x^2) - sum(x)^2) / n^2, 64 biten pontos; Q10.4 mintakbol a variancia
+    // egysege mar 1/256 count^2
+    uint64_t n = block.count;
+    uint64_t spread = n * block.sumSquares - static_cast<uint64_t>(block.sum) * block.sum;
+    uint32_t blockVarianceQ8 = static_cast<uint32_t>((spread << (8 - 2 * NOISE_FRAC_BITS)) / (n * n));
+    uint32_t meanQ8 = static_cast<uint32_t>((static_cast<uint64_t>(block.sum) << (8 - NOISE_FRAC_BITS)) / n);
+
+    uint32_t drift = meanQ8 > previousMeanQ8_ ? meanQ8 - previousMeanQ8_ : previousMeanQ8_ - meanQ8;
+    bool rest = havePrevious_ && drift <= NOISE_REST_DRIFT_Q8 &&
+                block.max - block.min <= (NOISE_REST_RANGE << NOISE_FRAC_BITS);
+    previousMeanQ8_ = meanQ8;
+    havePrevious_ = true;
+
+    if (!rest)
+    {
+        movingBlocks_++;
+        return true;
+    }
+    // Futo atlag a nyugalmi blokkokra (1/8 suly), az elso blokk inditja
+    if (restBlocks_ == 0)
+    {
+        varianceQ8_ = blockVarianceQ8;
+    }
+    else
+    {
+        varianceQ8_ += (static_cast<int32_t>(blockVarianceQ8 - varianceQ8_)) >> 3;
+    }
+    restBlocks_++;
+    return true;
+}
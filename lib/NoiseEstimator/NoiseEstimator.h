@@ -0,0 +1,76 @@
+#ifndef NOISEESTIMATOR_H
+#define NOISEESTIMATOR_H
+
+#include <stdint.h>
+
+const uint16_t NOISE_BLOCK = 256;          // mintak blokkonkent (128 ms 2 kHz-en)
+const uint16_t NOISE_REST_RANGE = 32;      // nyugalmi blokk: max - min legfeljebb ennyi count
+const uint16_t NOISE_REST_DRIFT_Q8 = 256;  // nyugalmi blokk: az atlag legfeljebb 1 countot mozdul
+const uint8_t NOISE_MIN_REST_BLOCKS = 4;   // ennyi nyugalmi blokk utan hasznalhato a becsles
+const uint8_t NOISE_FRAC_BITS = 4;         // a mintak tort bitjei a blokk osszegekben (Q10.4)
+
+// Egy blokk osszegei; egesz aritmetika, igy nincs kioltasi hiba
+struct NoiseBlock
+{
+  uint32_t sum;        // Q10.4: 256 * 2^14 < 2^22
+  uint64_t sumSquares; // 256 * (2^14)^2 = 2^36
+  uint16_t min;
+  uint16_t max;
+  uint16_t count;
+};
+
+//
+// NoiseEstimator Class
+// Per-channel noise variance measured only while the axis is at rest. The
+// acquisition path just adds each sample to the current block; completed
+// blocks are evaluated later from a low-priority task with process(), so
+// the statistics never stall acquisition. A block counts as rest when its
+// spread is small and its mean has not moved since the previous block;
+// rest block variances are averaged into a running estimate.
+//
+class NoiseEstimator {
+public:
+  NoiseEstimator();
+
+  // Minta hozzaadasa Q10.16-ban (acquisition, olcso); a CIC es a korrekcio tort bitjei a
+  // zajba is beleszamitanak, nem csak a kerekites lepcsoi
+  inline void add(uint32_t valueQ16)
+  {
+    uint16_t value = static_cast<uint16_t>((valueQ16 + (1UL << (15 - NOISE_FRAC_BITS))) >> (16 - NOISE_FRAC_BITS));
+    block_.sum += value;
+    block_.sumSquares += static_cast<uint32_t>(value) * value;
+    if (value < block_.min) block_.min = value;
+    if (value > block_.max) block_.max = value;
+    if (++block_.count == NOISE_BLOCK)
+    {
+      ready_ = block_;
+      readyValid_ = true;
+      startBlock();
+    }
+  }
+
+  // Kesz blokk kiertekelese; true, ha volt kesz blokk
+  bool process();
+
+  void reset();
+
+  // Zaj variancia count^2 * 256 egysegben, a nyugalmi blokkok atlaga
+  uint32_t varianceQ8() const { return varianceQ8_; }
+  bool hasEstimate() const { return restBlocks_ >= NOISE_MIN_REST_BLOCKS; }
+  uint32_t restBlocks() const { return restBlocks_; }
+  uint32_t movingBlocks() const { return movingBlocks_; }
+
+private:
+  void startBlock();
+
+  NoiseBlock block_;
+  NoiseBlock ready_;
+  volatile bool readyValid_;
+  bool havePrevious_;
+  uint32_t previousMeanQ8_;
+  uint32_t varianceQ8_;
+  uint32_t restBlocks_;
+  uint32_t movingBlocks_;
+};
+
+#endif // NOISEESTIMATOR_H
@@ -19,17 +19,24 @@
 #include "PluggableUSBHID.h"
 #include "PicoGamepad.h"
 #include "usb_phy_api.h"
+#include "LatencyProbe.h"
+
+#define GAMEPAD_REPORT_ID 0x01
+#define GAMEPAD_REPORT_LENGTH 51 // report ID + 50 bajt adat
 
 #define REPORT_ID_KEYBOARD 1
 #define REPORT_ID_VOLUME 3
 
 using namespace arduino;
 
-//uint8_t inputArray[35];
-
-PicoGamepad::PicoGamepad(bool connect, uint16_t vendor_id, uint16_t product_id, uint16_t product_release) : USBHID(get_usb_phy(), 0, 0, vendor_id, product_id, product_release)
+// A kapcsolodast az Arduino mbed core vegzi (PluggableUSBD().begin()), a connect parameter
+// csak a USBMouse-szal egyezo API miatt maradt
+PicoGamepad::PicoGamepad(bool /*connect*/, uint16_t vendor_id, uint16_t product_id, uint16_t product_release) : USBHID(get_usb_phy(), 0, 0, vendor_id, product_id, product_release)
 {
     //_lock_status = 0;
+    memset(&_report, 0, sizeof(_report));
+    _report.data[0] = GAMEPAD_REPORT_ID;
+    _report.length = GAMEPAD_REPORT_LENGTH;
     for (int i = 0; i < 4; i++)
     {
         SetHat(i, HAT_DIR_C);
@@ -39,6 +46,9 @@ PicoGamepad::PicoGamepad(bool connect, uint16_t vendor_id, uint16_t product_id,
 PicoGamepad::PicoGamepad(USBPhy *phy, uint16_t vendor_id, uint16_t product_id, uint16_t product_release) : USBHID(phy, 0, 0, vendor_id, product_id, product_release)
 {
     //_lock_status = 0;
+    memset(&_report, 0, sizeof(_report));
+    _report.data[0] = GAMEPAD_REPORT_ID;
+    _report.length = GAMEPAD_REPORT_LENGTH;
     for (int i = 0; i < 4; i++)
     {
         SetHat(i, HAT_DIR_C);
@@ -48,10 +58,6 @@ PicoGamepad::PicoGamepad(USBPhy *phy, uint16_t vendor_id, uint16_t product_id, u
 
 PicoGamepad::~PicoGamepad()
 {
-    // for (int i = 0; i < 35; i++)
-    // {
-    //     inputArray[i] = 0;
-    // }
     for (int i = 0; i < 4; i++)
     {
         SetHat(i, HAT_DIR_C);
@@ -151,11 +157,11 @@ bool PicoGamepad::randomizeInputs()
 
 void PicoGamepad::SetButton(int idx, bool val)
 {
-    if (idx > 128 || idx < 0)
+    if (idx > 127 || idx < 0)
     {
         return;
     }
-    bitWrite(inputArray[idx / 8], idx % 8, val);
+    bitWrite(_report.data[1 + idx / 8], idx % 8, val);
 }
 
 void PicoGamepad::SetAxis(int idx, uint16_t val)
@@ -168,151 +174,128 @@ void PicoGamepad::SetAxis(int idx, uint16_t val)
         idx = 25 - idx;
     }
 
-    inputArray[16 + (idx * 2)] = LSB(val);
-    inputArray[16 + (idx * 2)+1] = MSB(val);
+    _report.data[1 + 16 + (idx * 2)] = LSB(val);
+    _report.data[1 + 16 + (idx * 2)+1] = MSB(val);
 }
 
 void PicoGamepad::SetX(uint16_t val)
 {
-    inputArray[X_AXIS_LSB] = LSB(val);
-    inputArray[X_AXIS_MSB] = MSB(val);
+    _report.data[1 + X_AXIS_LSB] = LSB(val);
+    _report.data[1 + X_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetY(uint16_t val)
 {
-    inputArray[Y_AXIS_LSB] = LSB(val);
-    inputArray[Y_AXIS_MSB] = MSB(val);
+    _report.data[1 + Y_AXIS_LSB] = LSB(val);
+    _report.data[1 + Y_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetZ(uint16_t val)
 {
-    inputArray[Z_AXIS_LSB] = LSB(val);
-    inputArray[Z_AXIS_MSB] = MSB(val);
+    _report.data[1 + Z_AXIS_LSB] = LSB(val);
+    _report.data[1 + Z_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetRx(uint16_t val)
 {
-    inputArray[Rx_AXIS_LSB] = LSB(val);
-    inputArray[Rx_AXIS_MSB] = MSB(val);
+    _report.data[1 + Rx_AXIS_LSB] = LSB(val);
+    _report.data[1 + Rx_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetRy(uint16_t val)
 {
-    inputArray[Ry_AXIS_LSB] = LSB(val);
-    inputArray[Ry_AXIS_MSB] = MSB(val);
+    _report.data[1 + Ry_AXIS_LSB] = LSB(val);
+    _report.data[1 + Ry_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetRz(uint16_t val)
 {
-    inputArray[Rz_AXIS_LSB] = LSB(val);
-    inputArray[Rz_AXIS_MSB] = MSB(val);
+    _report.data[1 + Rz_AXIS_LSB] = LSB(val);
+    _report.data[1 + Rz_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetSlider(uint16_t val)
 {
-    inputArray[SLIDER_AXIS_LSB] = LSB(val);
-    inputArray[SLIDER_AXIS_MSB] = MSB(val);
+    _report.data[1 + SLIDER_AXIS_LSB] = LSB(val);
+    _report.data[1 + SLIDER_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetDial(uint16_t val)
 {
-    inputArray[DIAL_AXIS_LSB] = LSB(val);
-    inputArray[DIAL_AXIS_MSB] = MSB(val);
+    _report.data[1 + DIAL_AXIS_LSB] = LSB(val);
+    _report.data[1 + DIAL_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetWheel(uint16_t val)
 {
-    inputArray[WHEEL_AXIS_LSB] = LSB(val);
-    inputArray[WHEEL_AXIS_MSB] = MSB(val);
+    _report.data[1 + WHEEL_AXIS_LSB] = LSB(val);
+    _report.data[1 + WHEEL_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetVx(uint16_t val)
 {
-    inputArray[Vx_AXIS_LSB] = LSB(val);
-    inputArray[Vx_AXIS_MSB] = MSB(val);
+    _report.data[1 + Vx_AXIS_LSB] = LSB(val);
+    _report.data[1 + Vx_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetVy(uint16_t val)
 {
-    inputArray[Vy_AXIS_LSB] = LSB(val);
-    inputArray[Vy_AXIS_MSB] = MSB(val);
+    _report.data[1 + Vy_AXIS_LSB] = LSB(val);
+    _report.data[1 + Vy_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetVz(uint16_t val)
 {
-    inputArray[Vz_AXIS_LSB] = LSB(val);
-    inputArray[Vz_AXIS_MSB] = MSB(val);
+    _report.data[1 + Vz_AXIS_LSB] = LSB(val);
+    _report.data[1 + Vz_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetVbrx(uint16_t val)
 {
-    inputArray[Vbrx_AXIS_LSB] = LSB(val);
-    inputArray[Vbrx_AXIS_MSB] = MSB(val);
+    _report.data[1 + Vbrx_AXIS_LSB] = LSB(val);
+    _report.data[1 + Vbrx_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetVbry(uint16_t val)
 {
-    inputArray[Vbry_AXIS_LSB] = LSB(val);
-    inputArray[Vbry_AXIS_MSB] = MSB(val);
+    _report.data[1 + Vbry_AXIS_LSB] = LSB(val);
+    _report.data[1 + Vbry_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetVbrz(uint16_t val)
 {
-    inputArray[Vbrz_AXIS_LSB] = LSB(val);
-    inputArray[Vbrz_AXIS_MSB] = MSB(val);
+    _report.data[1 + Vbrz_AXIS_LSB] = LSB(val);
+    _report.data[1 + Vbrz_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetVno(uint16_t val)
 {
-    inputArray[Vno_AXIS_LSB] = LSB(val);
-    inputArray[Vno_AXIS_MSB] = MSB(val);
+    _report.data[1 + Vno_AXIS_LSB] = LSB(val);
+    _report.data[1 + Vno_AXIS_MSB] = MSB(val);
 }
 
 void PicoGamepad::SetUndefined(uint16_t val)
 {
-    inputArray[UNDEF_AXIS_LSB] = LSB(val);
-    inputArray[UNDEF_AXIS_MSB] = MSB(val);
+    _report.data[1 + UNDEF_AXIS_LSB] = LSB(val);
+    _report.data[1 + UNDEF_AXIS_MSB] = MSB(val);
 }
 
 
 void PicoGamepad::SetHat(uint8_t hatIdx, uint8_t dir)
 {
-    uint8_t hatDir[9][4] = {
-        {0, 0, 0, 0},
-        {0, 0, 0, 1},
-        {0, 0, 1, 0},
-        {0, 0, 1, 1},
-        {0, 1, 0, 0},
-        {0, 1, 0, 1},
-        {0, 1, 1, 0},
-        {0, 1, 1, 1},
-        {1, 0, 0, 0}};
-    switch (hatIdx)
+    // Az irany kodja (0-8) egyben a 4 bites nibble erteke, nincs szukseg tablara
+    if (hatIdx > 3 || dir > HAT_DIR_C)
+    {
+        return;
+    }
+    uint8_t &hats = _report.data[1 + (hatIdx < 2 ? HAT0_1 : HAT2_3)];
+    if (hatIdx & 1)
+    {
+        hats = (hats & 0x0F) | (dir << 4);
+    }
+    else
     {
-    case 0:
-        for (int i = 0; i < 4; i++)
-        {
-            bitWrite(inputArray[HAT0_1], 3 - i, hatDir[dir][i]);
-        }
-        break;
-    case 1:
-        for (int i = 0; i < 4; i++)
-        {
-            bitWrite(inputArray[HAT0_1], 7 - i, hatDir[dir][i]);
-        }
-        break;
-    case 2:
-        for (int i = 0; i < 4; i++)
-        {
-            bitWrite(inputArray[HAT2_3], 3 - i, hatDir[dir][i]);
-        }
-        break;
-    case 3:
-        for (int i = 0; i < 4; i++)
-        {
-            bitWrite(inputArray[HAT2_3], 7 - i, hatDir[dir][i]);
-        }
-        break;
+        hats = (hats & 0xF0) | dir;
     }
 }
 
@@ -320,16 +303,10 @@ bool PicoGamepad::send_update()
 {
     _mutex.lock();
 
-    HID_REPORT report;
-    report.data[0] = 0x01;
-    for (int i = 1; i < 51; i++)
-    {
-        report.data[i] = inputArray[i - 1];
-    }
+    // A report kozvetlenul a _report-ban all ossze, nincs masolat a stack-en
+    LATENCY_MARK(MARK_PACK_END);
 
-    report.length = 51;
-
-    if (!send(&report))
+    if (!send(&_report))
     {
         _mutex.unlock();
         return false;
@@ -188,6 +188,9 @@ namespace arduino
         void SetHat(uint8_t hatIdx, uint8_t dir);
 
         bool send_update();
+
+        // A bemeneti tomb (BTN0_7 .. HAT2_3), kozvetlen iras az AxisRouter-nek
+        uint8_t *inputs() { return &_report.data[1]; }
         /*
     * To define the report descriptor. Warning: this method has to store the length of the report descriptor in reportLength.
     *
@@ -204,7 +207,8 @@ namespace arduino
         virtual const uint8_t *configuration_desc(uint8_t index);
 
     private:
-        uint8_t inputArray[51];
+        // A kuldendo report: data[0] = report ID, utana a 50 bajtos bemeneti tomb (BTN0_7 .. HAT2_3)
+        HID_REPORT _report;
 
         uint8_t _configuration_descriptor[41];
         PlatformMutex _mutex;
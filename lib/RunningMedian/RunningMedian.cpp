@@ -0,0 +1,109 @@
+#include <RunningMedian.h>
+#include <MemoryReport.h>
+#include <string.h>
+
+RunningMedian::RunningMedian() : window_(1)
+{
+    reset();
+}
+
+void RunningMedian::setWindow(uint8_t window)
+{
+    if (window < 1)
+    {
+        window = 1;
+    }
+    if (window > MEDIAN_MAX_WINDOW)
+    {
+        window = MEDIAN_MAX_WINDOW;
+    }
+    window_ = window;
+    reset();
+}
+
+void RunningMedian::reset()
+{
+    count_ = 0;
+    head_ = 0;
+    memset(coarse_, 0, sizeof(coarse_));
+    memset(fine_, 0, sizeof(fine_));
+    fineBin_ = 0;
+}
+
+uint16_t RAM_FUNC("median") RunningMedian::operator()(uint16_t value)
+{
+    if (value >= MEDIAN_DOMAIN)
+    {
+        value = MEDIAN_DOMAIN - 1;
+    }
+
+    // A legregebbi minta kivetele, ha az ablak tele van
+    if (count_ == window_)
+    {
+        uint16_t oldest = samples_[head_];
+        coarse_[oldest >> MEDIAN_COARSE_BITS]--;
+        if ((oldest >> MEDIAN_COARSE_BITS) == fineBin_)
+        {
+            fine_[oldest & ((1 << MEDIAN_COARSE_BITS) - 1)]--;
+        }
+    }
+    else
+    {
+        count_++;
+    }
+
+    samples_[head_] = value;
+    coarse_[value >> MEDIAN_COARSE_BITS]++;
+    if ((value >> MEDIAN_COARSE_BITS) == fineBin_)
+    {
+        fine_[value & ((1 << MEDIAN_COARSE_BITS) - 1)]++;
+    }
+    if (++head_ == window_)
+    {
+        head_ = 0;
+    }
+
+    return median();
+}
+
+// A finom szamlalok atallitasa egy masik durva binre, az ablak mintaibol
+// (count_ < window_ eseten a mintak az elejen vannak)
+void RAM_FUNC("median") RunningMedian::trackFineBin(uint8_t bin)
+{
+    memset(fine_, 0, sizeof(fine_));
+    for (uint8_t i = 0; i < count_; ++i)
+    {
+        if ((samples_[i] >> MEDIAN_COARSE_BITS) == bin)
+        {
+            fine_[samples_[i] & ((1 << MEDIAN_COARSE_BITS) - 1)]++;
+        }
+    }
+    fineBin_ = bin;
+}
+
+uint16_t RAM_FUNC("median") RunningMedian::median()
+{
+    // Az also median rangja (paros ablaknal a kisebbik kozepso elem)
+    uint8_t rank = (count_ - 1) / 2;
+
+    uint8_t bin = 0;
+    while (rank >= coarse_[bin])
+    {
+        rank -= coarse_[bin];
+        bin++;
+    }
+
+    // A median ritkan lep at masik durva binbe; csak akkor kell az ablakot vegignezni
+    if (bin != fineBin_)
+    {
+        trackFineBin(bin);
+    }
+
+    uint8_t offset = 0;
+    while (rank >= fine_[offset])
+    {
+        rank -= fine_[offset];
+        offset++;
+    }
+    return (static_cast<uint16_t>(bin) << MEDIAN_COARSE_BITS) + offset;
+}
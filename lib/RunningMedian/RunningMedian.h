@@ -0,0 +1,47 @@
+#ifndef RUNNINGMEDIAN_H
+#define RUNNINGMEDIAN_H
+
+#include <stdint.h>
+
+const uint16_t MEDIAN_DOMAIN = 1024;      // 10 bites ADC ertekkeszlet
+const uint8_t MEDIAN_COARSE_BITS = 5;     // 32 durva bin, binenkent 32 ertek
+const uint8_t MEDIAN_MAX_WINDOW = 31;     // legnagyobb ablakmeret
+
+//
+// RunningMedian Class
+// Sliding-window median over the 10-bit ADC domain. Samples are counted in
+// 32 coarse bins of 32 values, plus 32 fine counts for the one coarse bin
+// that holds the median; both are updated in constant time as samples enter
+// and leave the window. Finding the median walks at most 32 + 32 bins. Only
+// when the median moves into another coarse bin are the fine counts rebuilt
+// from the window, which costs O(window), at most MEDIAN_MAX_WINDOW = 31
+// steps. The state is about 130 bytes instead of a 1 KB histogram per
+// channel.
+//
+class RunningMedian {
+public:
+  RunningMedian();
+
+  // Ablakmeret beallitasa (1..MEDIAN_MAX_WINDOW), torli az eddigi mintakat
+  void setWindow(uint8_t window);
+  uint8_t getWindow() const { return window_; }
+
+  // Uj minta hozzaadasa, visszaadja az ablak medianjat
+  uint16_t operator()(uint16_t value);
+
+  void reset();
+
+private:
+  uint16_t median();
+  void trackFineBin(uint8_t bin);
+
+  uint8_t window_;
+  uint8_t count_;
+  uint8_t head_;
+  uint16_t samples_[MEDIAN_MAX_WINDOW];
+  uint8_t coarse_[MEDIAN_DOMAIN >> MEDIAN_COARSE_BITS];
+  uint8_t fineBin_;                          // a finom szamlalok ehhez a durva binhez tartoznak
+  uint8_t fine_[1 << MEDIAN_COARSE_BITS];
+};
+
+#endif // RUNNINGMEDIAN_H
@@ -0,0 +1,120 @@
+#include <SampleStream.h>
+#include <Storage.h>
+
+static inline uint8_t *putU16(uint8_t *p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static inline uint8_t *putU32(uint8_t *p, uint32_t v)
+{
+    p = putU16(p, v & 0xFFFF);
+    return putU16(p, v >> 16);
+}
+
+SampleStream::SampleStream(Print *out)
+    : out_(out), enabled_(false), sequence_(0), dropped_(0),
+      droppedTotal_(0), sent_(0), head_(0), tail_(0)
+{
+}
+
+void SampleStream::setEnabled(bool enabled)
+{
+    enabled_ = enabled;
+    if (enabled)
+    {
+        sequence_ = 0;
+        dropped_ = 0;
+        droppedTotal_ = 0;
+        sent_ = 0;
+        tail_ = head_;
+    }
+}
+
+uint16_t SampleStream::cobsEncode(const uint8_t *input, uint16_t length, uint8_t *output)
+{
+    uint16_t codeIndex = 0;
+    uint16_t outIndex = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < length; ++i)
+    {
+        if (input[i] == 0)
+        {
+            output[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+            continue;
+        }
+        output[outIndex++] = input[i];
+        if (++code == 0xFF)
+        {
+            output[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        }
+    }
+    output[codeIndex] = code;
+    output[outIndex++] = 0x00; // csomag hatar
+    return outIndex;
+}
+
+void SampleStream::push(const StreamSample &sample)
+{
+    if (!enabled_)
+    {
+        return;
+    }
+
+    uint8_t next = (head_ + 1) % STREAM_QUEUE_LENGTH;
+    if (next == tail_)
+    {
+        // A host lemaradt: eldobjuk es szamoljuk
+        dropped_++;
+        droppedTotal_++;
+        sequence_++;
+        return;
+    }
+
+    uint8_t payload[STREAM_PAYLOAD_LENGTH];
+    uint8_t *p = payload;
+    *p++ = STREAM_PACKET_SAMPLE;
+    *p++ = STREAM_CHANNELS;
+    p = putU16(p, sequence_++);
+    p = putU32(p, sample.timestampUs);
+    p = putU16(p, dropped_);
+    for (uint8_t ch = 0; ch < STREAM_CHANNELS; ++ch)
+    {
+        p = putU16(p, sample.raw[ch]);
+    }
+    for (uint8_t ch = 0; ch < STREAM_CHANNELS; ++ch)
+    {
+        p = putU16(p, sample.filtered[ch]);
+    }
+    for (uint8_t ch = 0; ch < STREAM_CHANNELS; ++ch)
+    {
+        p = putU16(p, static_cast<uint16_t>(sample.mapped[ch]));
+    }
+    putU16(p, storageCrc16(payload, STREAM_PAYLOAD_LENGTH - 2));
+    dropped_ = 0;
+
+    frameLength_[head_] = cobsEncode(payload, STREAM_PAYLOAD_LENGTH, frames_[head_]);
+    head_ = next;
+}
+
+void SampleStream::flush()
+{
+    while (tail_ != head_)
+    {
+        uint8_t length = frameLength_[tail_];
+        if (out_->availableForWrite() < length)
+        {
+            return; // nem varunk a hostra, a kovetkezo korben folytatjuk
+        }
+        out_->write(frames_[tail_], length);
+        tail_ = (tail_ + 1) % STREAM_QUEUE_LENGTH;
+        sent_++;
+    }
+}
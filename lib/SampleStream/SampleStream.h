@@ -0,0 +1,66 @@
+#ifndef SAMPLESTREAM_H
+#define SAMPLESTREAM_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+const uint8_t STREAM_CHANNELS = 8;
+const uint8_t STREAM_PACKET_SAMPLE = 0x01;  // csomag tipus
+const uint8_t STREAM_QUEUE_LENGTH = 8;      // kodolt csomagok a kuldesi sorban
+
+// Csomag tartalma (little-endian, a host oldali dekoder ugyanigy olvassa):
+//   u8 type, u8 channels, u16 sequence, u32 timestamp_us, u16 dropped,
+//   u16 raw[8], u16 filtered[8], i16 mapped[8], u16 crc16 (CCITT-FALSE)
+const uint8_t STREAM_PAYLOAD_LENGTH = 10 + 6 * STREAM_CHANNELS + 2;
+// COBS: +1 bajt 254 bajtonkent, +1 a 0x00 lezaro
+const uint8_t STREAM_FRAME_LENGTH = STREAM_PAYLOAD_LENGTH + STREAM_PAYLOAD_LENGTH / 254 + 2;
+
+struct StreamSample
+{
+  uint32_t timestampUs;
+  uint16_t raw[STREAM_CHANNELS];
+  uint16_t filtered[STREAM_CHANNELS];
+  int16_t mapped[STREAM_CHANNELS];
+};
+
+//
+// SampleStream Class
+// Binary diagnostics stream over the CDC serial port. push() encodes one
+// sample into a COBS frame in a small RAM queue, it never touches the port;
+// flush() writes queued frames only while the port can take them without
+// blocking. If the queue is full the sample is dropped and counted, the
+// counter travels in the next packet so the host sees the gaps.
+//
+class SampleStream {
+public:
+  SampleStream(Print *out);
+
+  void setEnabled(bool enabled);
+  bool isEnabled() const { return enabled_; }
+
+  // Minta sorba allitasa (az acquisition task hivja)
+  void push(const StreamSample &sample);
+
+  // Sorban allo csomagok kiirasa blokkolas nelkul (alacsony prioritasu task)
+  void flush();
+
+  uint32_t sentCount() const { return sent_; }
+  uint32_t droppedCount() const { return droppedTotal_; }
+
+  // COBS kodolas; visszaadja a kimenet hosszat a 0x00 lezaroval egyutt
+  static uint16_t cobsEncode(const uint8_t *input, uint16_t length, uint8_t *output);
+
+private:
+  Print *out_;
+  bool enabled_;
+  uint16_t sequence_;
+  uint16_t dropped_;       // az utolso elkuldott csomag ota eldobott
+  uint32_t droppedTotal_;
+  uint32_t sent_;
+  uint8_t frames_[STREAM_QUEUE_LENGTH][STREAM_FRAME_LENGTH];
+  uint8_t frameLength_[STREAM_QUEUE_LENGTH];
+  volatile uint8_t head_;  // kovetkezo irando hely
+  volatile uint8_t tail_;  // kovetkezo kuldendo csomag
+};
+
+#endif // SAMPLESTREAM_H
@@ -0,0 +1,248 @@
+#include <Scheduler.h>
+
+#ifdef ARDUINO_ARCH_MBED_RP2040
+#include <hardware/timer.h>
+#include <hardware/sync.h>
+
+// A mbed core a 0. alarmot hasznalja, az utolsot foglaljuk le az ebresztesre
+static const uint8_t WAKE_ALARM = 3;
+static bool wakeAlarmClaimed = false;
+
+static void wakeAlarmCallback(uint alarm_num)
+{
+    // Csak fel kell ebreszteni a WFE-bol, a megszakitas ezt elvegzi
+}
+
+static void rp2040Idle(uint32_t wakeAtUs)
+{
+    if (!wakeAlarmClaimed)
+    {
+        hardware_alarm_claim(WAKE_ALARM);
+        hardware_alarm_set_callback(WAKE_ALARM, wakeAlarmCallback);
+        wakeAlarmClaimed = true;
+    }
+    // true: az idopont mar elmult, nincs mire varni
+    uint64_t now = time_us_64();
+    uint64_t target = now + static_cast<int32_t>(wakeAtUs - static_cast<uint32_t>(now));
+    if (!hardware_alarm_set_target(WAKE_ALARM, from_us_since_boot(target)))
+    {
+        __wfe();
+    }
+}
+#endif
+
+static uint32_t defaultClock()
+{
+    return micros();
+}
+
+// Elojeles kulonbseg, hogy a 32 bites ora atfordulasa ne zavarjon
+static inline int32_t timeDiff(uint32_t a, uint32_t b)
+{
+    return static_cast<int32_t>(a - b);
+}
+
+static void defaultIdle(uint32_t wakeAtUs)
+{
+#if defined(ARDUINO_ARCH_MBED_RP2040)
+    rp2040Idle(wakeAtUs);
+#elif defined(ARDUINO_ARCH_SIM)
+    // Szimulatorban a virtualis ora ugrik elore a kovetkezo taskig
+    int32_t remaining = timeDiff(wakeAtUs, micros());
+    if (remaining > 0)
+    {
+        delayMicroseconds(remaining);
+    }
+#endif
+}
+
+Scheduler::Scheduler(SchedulerClock clock, SchedulerIdle idle)
+    : clock_(clock ? clock : defaultClock),
+      idle_(idle ? idle : defaultIdle),
+      taskCount_(0)
+{
+}
+
+int8_t Scheduler::addTask(const char *name, TaskFunction function, void *context,
+                          uint32_t periodUs, uint8_t priority, uint32_t deadlineUs)
+{
+    if (taskCount_ >= SCHEDULER_MAX_TASKS || function == nullptr)
+    {
+        return -1;
+    }
+
+    Task &t = tasks_[taskCount_];
+    t.name = name;
+    t.function = function;
+    t.context = context;
+    t.periodUs = periodUs;
+    t.deadlineUs = deadlineUs;
+    t.priority = priority;
+    t.enabled = true;
+    t.pending = false;
+    t.releaseUs = clock_();
+    t.stats = TaskStats();
+    return taskCount_++;
+}
+
+void Scheduler::setPeriod(int8_t id, uint32_t periodUs)
+{
+    if (id < 0 || id >= taskCount_)
+    {
+        return;
+    }
+    tasks_[id].periodUs = periodUs;
+}
+
+void Scheduler::setEnabled(int8_t id, bool enabled)
+{
+    if (id < 0 || id >= taskCount_)
+    {
+        return;
+    }
+    Task &t = tasks_[id];
+    if (enabled && !t.enabled)
+    {
+        t.releaseUs = clock_();
+    }
+    t.enabled = enabled;
+}
+
+void Scheduler::trigger(int8_t id)
+{
+    if (id < 0 || id >= taskCount_)
+    {
+        return;
+    }
+    tasks_[id].pending = true;
+    tasks_[id].releaseUs = clock_();
+}
+
+int8_t Scheduler::selectReady(uint32_t nowUs) const
+{
+    int8_t best = -1;
+    for (uint8_t i = 0; i < taskCount_; ++i)
+    {
+        const Task &t = tasks_[i];
+        if (!t.enabled || (t.periodUs == 0 && !t.pending) || timeDiff(nowUs, t.releaseUs) < 0)
+        {
+            continue;
+        }
+        if (best < 0 || t.priority < tasks_[best].priority ||
+            (t.priority == tasks_[best].priority && timeDiff(t.releaseUs, tasks_[best].releaseUs) < 0))
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool Scheduler::runOnce()
+{
+    uint32_t start = clock_();
+    int8_t id = selectReady(start);
+    if (id < 0)
+    {
+        return false;
+    }
+
+    Task &t = tasks_[id];
+    uint32_t release = t.releaseUs;
+    t.pending = false;
+    t.function(t.context);
+    uint32_t end = clock_();
+
+    // Futasi ido es deadline ellenorzes
+    uint32_t runUs = end - start;
+    t.stats.runs++;
+    t.stats.lastRunUs = runUs;
+    t.stats.totalRunUs += runUs;
+    if (runUs > t.stats.maxRunUs)
+    {
+        t.stats.maxRunUs = runUs;
+    }
+    uint32_t deadline = t.deadlineUs ? t.deadlineUs : t.periodUs;
+    if (deadline && timeDiff(end, release + deadline) > 0)
+    {
+        t.stats.overruns++;
+    }
+
+    // Kovetkezo kiadas: fix racs, a lemaradt periodusokat atugorjuk
+    if (t.periodUs)
+    {
+        t.releaseUs = release + t.periodUs;
+        if (timeDiff(end, t.releaseUs) >= 0)
+        {
+            uint32_t behind = (end - t.releaseUs) / t.periodUs + 1;
+            t.stats.skipped += behind;
+            t.releaseUs += behind * t.periodUs;
+        }
+    }
+    return true;
+}
+
+bool Scheduler::nextReleaseUs(uint32_t &whenUs) const
+{
+    bool found = false;
+    for (uint8_t i = 0; i < taskCount_; ++i)
+    {
+        const Task &t = tasks_[i];
+        if (!t.enabled || (t.periodUs == 0 && !t.pending))
+        {
+            continue;
+        }
+        if (!found || timeDiff(t.releaseUs, whenUs) < 0)
+        {
+            whenUs = t.releaseUs;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void Scheduler::run()
+{
+    if (runOnce())
+    {
+        return;
+    }
+    uint32_t wakeAt;
+    if (nextReleaseUs(wakeAt))
+    {
+        idle_(wakeAt);
+    }
+}
+
+void Scheduler::resetStats()
+{
+    for (uint8_t i = 0; i < taskCount_; ++i)
+    {
+        tasks_[i].stats = TaskStats();
+    }
+}
+
+void Scheduler::printStats(Print &out) const
+{
+    // #TASK,<name>,<prio>,<period>,<runs>,<overruns>,<skipped>,<avg>,<max>
+    out.println("#TASK,name,prio,period_us,runs,overruns,skipped,avg_us,max_us");
+    for (uint8_t i = 0; i < taskCount_; ++i)
+    {
+        const Task &t = tasks_[i];
+        out.print("#TASK,");
+        out.print(t.name);
+        out.print(',');
+        out.print(t.priority);
+        out.print(',');
+        out.print(t.periodUs);
+        out.print(',');
+        out.print(t.stats.runs);
+        out.print(',');
+        out.print(t.stats.overruns);
+        out.print(',');
+        out.print(t.stats.skipped);
+        out.print(',');
+        out.print(t.stats.runs ? static_cast<uint32_t>(t.stats.totalRunUs / t.stats.runs) : 0UL);
+        out.print(',');
+        out.println(t.stats.maxRunUs);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+typedef void (*TaskFunction)(void *context);
+typedef uint32_t (*SchedulerClock)();             // aktualis ido mikroszekundumban
+typedef void (*SchedulerIdle)(uint32_t wakeAtUs); // alvas a megadott idopontig
+
+const uint8_t SCHEDULER_MAX_TASKS = 10; // a firmware 8-at hasznal, 2 tartalek
+
+// Futasi statisztika taskonkent
+struct TaskStats
+{
+  uint32_t runs = 0;       // lefutasok szama
+  uint32_t overruns = 0;   // deadline utan befejezett futasok
+  uint32_t skipped = 0;    // kimaradt periodusok (a task kesve indult)
+  uint32_t lastRunUs = 0;  // utolso futasi ido
+  uint32_t maxRunUs = 0;   // leghosszabb futasi ido
+  uint64_t totalRunUs = 0; // osszes futasi ido
+};
+
+struct Task
+{
+  const char *name;
+  TaskFunction function;
+  void *context;
+  uint32_t periodUs;    // 0 = egyszeri task, trigger() inditja
+  uint32_t deadlineUs;  // relativ deadline a kiadastol, 0 = periodus
+  uint8_t priority;     // kisebb ertek = fontosabb
+  bool enabled;
+  bool pending;         // egyszeri task kiadva
+  uint32_t releaseUs;   // kovetkezo kiadas idopontja
+  TaskStats stats;
+};
+
+//
+// Scheduler Class
+// Cooperative, non-preemptive scheduler: the ready task with the best
+// priority runs to completion, ties go to the earliest release. When no
+// task is ready the CPU sleeps until the next release. Clock and idle hooks
+// are injectable so the same code runs on a virtual clock on the host.
+//
+class Scheduler {
+public:
+  Scheduler(SchedulerClock clock = nullptr, SchedulerIdle idle = nullptr);
+
+  // Task regisztralasa, visszaadja az azonositot vagy -1-et, ha nincs hely
+  int8_t addTask(const char *name, TaskFunction function, void *context,
+                 uint32_t periodUs, uint8_t priority, uint32_t deadlineUs = 0);
+
+  void setPeriod(int8_t id, uint32_t periodUs);
+  void setEnabled(int8_t id, bool enabled);
+
+  // Egyszeri (vagy periodikus) task azonnali kiadasa
+  void trigger(int8_t id);
+
+  // A legfontosabb kesz task futtatasa; false, ha egy sem volt kesz
+  bool runOnce();
+
+  // runOnce(), es ha nincs kesz task, alvas a kovetkezo kiadasig
+  void run();
+
+  // Kovetkezo kiadas idopontja; false, ha nincs engedelyezett task
+  bool nextReleaseUs(uint32_t &whenUs) const;
+
+  uint8_t taskCount() const { return taskCount_; }
+  const Task &task(int8_t id) const { return tasks_[id]; }
+  void resetStats();
+  void printStats(Print &out) const;
+
+private:
+  int8_t selectReady(uint32_t nowUs) const;
+
+  SchedulerClock clock_;
+  SchedulerIdle idle_;
+  Task tasks_[SCHEDULER_MAX_TASKS];
+  uint8_t taskCount_;
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,45 @@
+#ifndef STATICSSD1306_H
+#define STATICSSD1306_H
+
+#include <Adafruit_SSD1306.h>
+
+//
+// StaticSSD1306 Class
+// Adafruit_SSD1306 with a statically allocated frame buffer. begin() only
+// mallocs when the buffer pointer is null, so setting it here keeps the
+// 1 KB buffer out of the heap and visible in the static memory report.
+// The bus traffic can also go through an I2CBus queue instead of begin()
+// and display(): send initCommands(), then flush frameBuffer().
+//
+template <uint8_t WIDTH_, uint8_t HEIGHT_>
+class StaticSSD1306 : public Adafruit_SSD1306 {
+public:
+  // clockHz: az Adafruit driver ezt allitja be, es ezt is hagyja vissza (a busz kozos orajele)
+  StaticSSD1306(TwoWire *wire, int8_t resetPin, uint32_t clockHz = 400000UL)
+      : Adafruit_SSD1306(WIDTH_, HEIGHT_, wire, resetPin, clockHz, clockHz)
+  {
+    buffer = frameBuffer_;
+  }
+
+  // Az alaposztaly destruktora free()-t hivna a bufferre
+  ~StaticSSD1306() { buffer = nullptr; }
+
+  const uint8_t *frameBuffer() const { return frameBuffer_; }
+  static uint16_t frameBufferSize() { return sizeof(frameBuffer_); }
+
+  // Ugyanaz az init sorozat, mint az Adafruit begin()-ben (belso toltopumpa, vizszintes cimzes)
+  static const uint8_t *initCommands(uint8_t &length)
+  {
+    static const uint8_t commands[] = {
+        SSD1306_DISPLAYOFF, 0xD5, 0x80, 0xA8, HEIGHT_ - 1, 0xD3, 0x00, 0x40,
+        0x8D, 0x14, 0x20, 0x00, 0xA1, 0xC8, 0xDA, HEIGHT_ == 64 ? 0x12 : 0x02,
+        0x81, 0xCF, 0xD9, 0xF1, 0xDB, 0x40, 0xA4, 0xA6, 0x2E, SSD1306_DISPLAYON};
+    length = sizeof(commands);
+    return commands;
+  }
+
+private:
+  uint8_t frameBuffer_[WIDTH_ * ((HEIGHT_ + 7) / 8)];
+};
+
+#endif // STATICSSD1306_H
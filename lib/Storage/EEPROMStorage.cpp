@@ -0,0 +1,90 @@
+#include <EEPROMStorage.h>
+
+EEPROMStorage::EEPROMStorage(I2CBus *bus, uint8_t address) : bus_(bus), address_(address)
+{
+    for (uint8_t i = 0; i < I2C_QUEUE_LENGTH; ++i)
+    {
+        writeStatus_[i] = I2C_JOB_DONE;
+    }
+}
+
+bool EEPROMStorage::isAvailable()
+{
+    // Iras ciklus alatt (~5 ms lapankent) a chip a cimre sem ACK-zik; amig sajat iras fut,
+    // az utolso ismert allapot ervenyes, a sor ACK pollinggal varja ki a chipet
+    if (!writePending())
+    {
+        present_ = bus_->probe(address_);
+    }
+    return present_;
+}
+
+bool EEPROMStorage::writePending() const
+{
+    for (uint8_t i = 0; i < I2C_QUEUE_LENGTH; ++i)
+    {
+        if (writeStatus_[i] == I2C_JOB_PENDING)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EEPROMStorage::read(uint16_t address, void *data, uint16_t length)
+{
+    volatile I2CJobStatus status;
+    if (!bus_->readMemory(address_, address, data, length, &status))
+    {
+        return false;
+    }
+    // Blokkol: a sorban elotte allo munkak is lefutnak
+    while (status == I2C_JOB_PENDING)
+    {
+        bus_->service();
+    }
+    return status == I2C_JOB_DONE;
+}
+
+bool EEPROMStorage::write(uint16_t address, const void *data, uint16_t length)
+{
+    // Sorba allitas; az adat bemasolodik, a lapokat a busz task irja
+    volatile I2CJobStatus &status = writeStatus_[nextStatus_];
+    nextStatus_ = (nextStatus_ + 1) % I2C_QUEUE_LENGTH;
+    if (status == I2C_JOB_FAILED)
+    {
+        writeFailed_ = true;
+    }
+    if (!bus_->writeMemory(address_, address, data, length, &status))
+    {
+        status = I2C_JOB_FAILED;
+        return false;
+    }
+    return true;
+}
+
+I2CJobStatus EEPROMStorage::writeStatus() const
+{
+    bool pending = false;
+    for (uint8_t i = 0; i < I2C_QUEUE_LENGTH; ++i)
+    {
+        if (writeStatus_[i] == I2C_JOB_FAILED)
+        {
+            return I2C_JOB_FAILED;
+        }
+        pending = pending || writeStatus_[i] == I2C_JOB_PENDING;
+    }
+    return writeFailed_ ? I2C_JOB_FAILED : pending ? I2C_JOB_PENDING : I2C_JOB_DONE;
+}
+
+void EEPROMStorage::clearWriteStatus()
+{
+    for (uint8_t i = 0; i < I2C_QUEUE_LENGTH; ++i)
+    {
+        if (writeStatus_[i] == I2C_JOB_FAILED)
+        {
+            writeStatus_[i] = I2C_JOB_DONE;
+        }
+    }
+    writeFailed_ = false;
+}
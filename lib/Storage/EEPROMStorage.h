@@ -0,0 +1,43 @@
+#ifndef EEPROMSTORAGE_H
+#define EEPROMSTORAGE_H
+
+#include <Storage.h>
+#include <I2CBus.h>
+
+//
+// EEPROMStorage Class
+// Storage on the I2C EEPROM (24LC64 on Wire1), through the shared I2CBus
+// queue. Writes are queued and return at once; the bus task writes the
+// pages with ACK polling and writeStatus() reports the combined outcome of
+// the writes since clearWriteStatus(). Reads wait
+// for the queue and block, so the control loop reads a prefetched image
+// instead (see MemoryStorage).
+//
+class EEPROMStorage : public Storage {
+public:
+  EEPROMStorage(I2CBus *bus, uint8_t address);
+
+  bool isAvailable() override;
+  bool read(uint16_t address, void *data, uint16_t length) override;
+  bool write(uint16_t address, const void *data, uint16_t length) override;
+
+  // A clearWriteStatus() ota indult irasok osszesitve: FAILED, ha barmelyik hibas volt,
+  // kulonben PENDING, amig barmelyik fut, egyebkent DONE
+  I2CJobStatus writeStatus() const;
+  // Uj mentes elott; a meg futo irasok tovabbra is szamitanak
+  void clearWriteStatus();
+
+private:
+  bool writePending() const;
+
+  I2CBus *bus_;
+  uint8_t address_;
+  bool present_ = false; // az utolso cim proba eredmenye
+  // Irasonkent kulon allapot, igy egy kesobbi sikeres iras nem takarja el egy korabbi hibajat.
+  // Egy futo iras legalabb egy helyet foglal a busz soraban, ennyi allapot eleg.
+  volatile I2CJobStatus writeStatus_[I2C_QUEUE_LENGTH];
+  uint8_t nextStatus_ = 0;
+  bool writeFailed_ = false; // mar ujrahasznalt allapot hibaja
+};
+
+#endif // EEPROMSTORAGE_H
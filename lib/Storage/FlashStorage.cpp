@@ -0,0 +1,173 @@
+#include <FlashStorage.h>
+#include <string.h>
+#include <hardware/flash.h>
+#include <hardware/sync.h>
+
+bool FlashStorage::begin()
+{
+    begun_ = shadow_ != nullptr && sizeof(FlashRecordHeader) + size_ <= FLASH_STORAGE_SECTOR &&
+             offset_ % FLASH_STORAGE_SECTOR == 0;
+    active_ = -1;
+    dirty_ = false;
+    if (!begun_)
+    {
+        return false;
+    }
+    for (uint8_t sector = 0; sector < 2; ++sector)
+    {
+        uint32_t sequence;
+        // Elojeles kulonbseg: a sorszam atfordulasa sem zavar
+        if (valid(sector, sequence) && (active_ < 0 || static_cast<int32_t>(sequence - sequence_) > 0))
+        {
+            active_ = sector;
+            sequence_ = sequence;
+        }
+    }
+    return active_ >= 0;
+}
+
+bool FlashStorage::isAvailable()
+{
+    return begun_;
+}
+
+bool FlashStorage::contains(uint16_t address, uint16_t length) const
+{
+    return begun_ && address >= base_ && static_cast<uint32_t>(address - base_) + length <= size_;
+}
+
+const FlashRecordHeader *FlashStorage::sectorHeader(uint8_t sector) const
+{
+    return reinterpret_cast<const FlashRecordHeader *>(XIP_BASE + sectorOffset(sector));
+}
+
+const uint8_t *FlashStorage::sectorData(uint8_t sector) const
+{
+    return reinterpret_cast<const uint8_t *>(XIP_BASE + sectorOffset(sector)) + sizeof(FlashRecordHeader);
+}
+
+uint16_t FlashStorage::recordCrc(uint32_t sequence, const uint8_t *data) const
+{
+    uint16_t crc = storageCrc16(&sequence, sizeof(sequence));
+    crc = storageCrc16(&size_, sizeof(size_), crc);
+    return storageCrc16(data, size_, crc);
+}
+
+// Teljes, sertetlen kep: magic, a kep merete es a CRC is stimmel
+bool FlashStorage::valid(uint8_t sector, uint32_t &sequence) const
+{
+    FlashRecordHeader header;
+    memcpy(&header, sectorHeader(sector), sizeof(header));
+    if (header.magic != FLASH_STORAGE_MAGIC || header.length != size_ ||
+        header.crc != recordCrc(header.sequence, sectorData(sector)))
+    {
+        return false;
+    }
+    sequence = header.sequence;
+    return true;
+}
+
+const uint8_t *FlashStorage::view(uint16_t address, uint16_t length) const
+{
+    if (!contains(address, length))
+    {
+        return nullptr;
+    }
+    if (dirty_)
+    {
+        return shadow_ + (address - base_);
+    }
+    return active_ >= 0 ? sectorData(active_) + (address - base_) : nullptr;
+}
+
+bool FlashStorage::read(uint16_t address, void *data, uint16_t length)
+{
+    const uint8_t *source = view(address, length);
+    if (source == nullptr)
+    {
+        return false; // ures flash: a hivo az alapertelmezettet hasznalja
+    }
+    memcpy(data, source, length);
+    return true;
+}
+
+bool FlashStorage::write(uint16_t address, const void *data, uint16_t length)
+{
+    if (!contains(address, length))
+    {
+        return false;
+    }
+    uint16_t index = address - base_;
+    if (!dirty_)
+    {
+        // Valtozatlan adat nem koptatja a flash-t
+        if (active_ >= 0 && memcmp(sectorData(active_) + index, data, length) == 0)
+        {
+            return true;
+        }
+        // Elso modositas: a shadow az aktiv kep masolata (ures flash eseten torolt allapot)
+        if (active_ >= 0)
+        {
+            memcpy(shadow_, sectorData(active_), size_);
+        }
+        else
+        {
+            memset(shadow_, 0xFF, size_);
+        }
+        dirty_ = true;
+    }
+    memcpy(shadow_ + index, data, length);
+    return true;
+}
+
+bool FlashStorage::commit()
+{
+    if (!dirty_)
+    {
+        return true;
+    }
+    if (!begun_)
+    {
+        return false;
+    }
+    uint8_t target = active_ == 0 ? 1 : 0;
+    uint32_t sequence = sequence_ + 1;
+    FlashRecordHeader header = {FLASH_STORAGE_MAGIC, sequence, size_, recordCrc(sequence, shadow_)};
+
+    // A flash muveletek alatt nincs XIP: megszakitas sem futhat flash-bol
+    uint32_t interrupts = save_and_disable_interrupts();
+    flash_range_erase(sectorOffset(target), FLASH_STORAGE_SECTOR);
+    restore_interrupts(interrupts);
+
+    // Lapok a kep vegetol; a 0. lap (fejlec) az utolso, addig a szektor ervenytelen
+    uint32_t total = sizeof(header) + size_;
+    uint8_t pages = (total + FLASH_STORAGE_PAGE - 1) / FLASH_STORAGE_PAGE;
+    uint8_t page[FLASH_STORAGE_PAGE];
+    for (int8_t p = pages - 1; p >= 0; --p)
+    {
+        memset(page, 0xFF, sizeof(page));
+        uint32_t start = p * FLASH_STORAGE_PAGE;
+        uint32_t end = start + FLASH_STORAGE_PAGE < total ? start + FLASH_STORAGE_PAGE : total;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            page[i - start] = i < sizeof(header) ? reinterpret_cast<const uint8_t *>(&header)[i]
+                                                 : shadow_[i - sizeof(header)];
+        }
+        interrupts = save_and_disable_interrupts();
+        flash_range_program(sectorOffset(target) + start, page, FLASH_STORAGE_PAGE);
+        restore_interrupts(interrupts);
+    }
+
+    // Visszaolvasas az XIP-bol; hiba eseten a regi szektor marad aktiv, a shadow megmarad
+    uint32_t written;
+    if (!valid(target, written) || written != sequence)
+    {
+        failures_++;
+        return false;
+    }
+    active_ = target;
+    sequence_ = sequence;
+    dirty_ = false;
+    commits_++;
+    return true;
+}
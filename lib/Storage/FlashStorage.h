@@ -0,0 +1,76 @@
+#ifndef FLASHSTORAGE_H
+#define FLASHSTORAGE_H
+
+#include <Storage.h>
+
+const uint32_t FLASH_STORAGE_SECTOR = 4096;  // RP2040 QSPI flash torlesi egyseg
+const uint16_t FLASH_STORAGE_PAGE = 256;     // programozasi egyseg
+const uint32_t FLASH_STORAGE_MAGIC = 0x53464A50; // "PJFS"
+
+// Szektor eleje; a CRC a sequence, length es az adat felett
+struct FlashRecordHeader
+{
+  uint32_t magic;
+  uint32_t sequence;  // minden commit() noveli, a nagyobb az ervenyes
+  uint16_t length;    // adat hossz, a kep merete
+  uint16_t crc;
+};
+
+//
+// FlashStorage Class
+// Storage in two reserved sectors of the RP2040's QSPI flash. Reads come
+// straight from the execute-in-place mapping, no bus and no staging copy
+// (view() even returns the mapped pointer). Writes only change a RAM
+// shadow of the image; commit() then programs the whole image into the
+// other sector, header page last, and switches over once it reads back
+// valid. A power loss during commit() leaves the previous sector intact,
+// begin() picks the newest sector with a good CRC.
+//
+class FlashStorage : public Storage {
+public:
+  // flashOffset: az elso szektor a flash elejetol (szektorhatar), a masodik utana kovetkezik.
+  // shadow: size bajtos RAM kep a commit()-ig tarto modositasokhoz
+  FlashStorage(uint32_t flashOffset, uint8_t *shadow, uint16_t size, uint16_t base = 0)
+      : offset_(flashOffset), shadow_(shadow), size_(size), base_(base) {}
+
+  // Ket szektor atnezese; false, ha egyikben sincs ervenyes kep (ures flash)
+  bool begin();
+
+  bool isAvailable() override;
+  bool read(uint16_t address, void *data, uint16_t length) override;
+  bool write(uint16_t address, const void *data, uint16_t length) override;
+
+  // Masolas nelkuli olvasas: mutato az XIP teruletre (vagy a meg nem irt RAM kepre); nullptr, ha nincs
+  const uint8_t *view(uint16_t address, uint16_t length) const;
+
+  // Modositasok kiirasa a masik szektorba. Szektor torles + lapok, megszakitasok tiltasaval:
+  // ~50 ms alatt nincs USB es timer, ezert csak mentes parancsra hivando
+  bool commit();
+  bool dirty() const { return dirty_; }
+
+  int8_t activeSector() const { return active_; }
+  uint32_t sequence() const { return sequence_; }
+  uint32_t commits() const { return commits_; }
+  uint32_t failures() const { return failures_; }
+
+private:
+  bool contains(uint16_t address, uint16_t length) const;
+  bool valid(uint8_t sector, uint32_t &sequence) const;
+  const uint8_t *sectorData(uint8_t sector) const;
+  const FlashRecordHeader *sectorHeader(uint8_t sector) const;
+  uint32_t sectorOffset(uint8_t sector) const { return offset_ + sector * FLASH_STORAGE_SECTOR; }
+  uint16_t recordCrc(uint32_t sequence, const uint8_t *data) const;
+
+  uint32_t offset_;
+  uint8_t *shadow_;
+  uint16_t size_;
+  uint16_t base_;
+  bool begun_ = false;
+  bool dirty_ = false;      // a shadow elter az aktiv szektortol
+  int8_t active_ = -1;      // ervenyes, legujabb szektor; -1 = nincs
+  uint32_t sequence_ = 0;
+  uint32_t commits_ = 0;
+  uint32_t failures_ = 0;
+};
+
+#endif // FLASHSTORAGE_H
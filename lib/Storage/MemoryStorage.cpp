@@ -0,0 +1,27 @@
+#include <MemoryStorage.h>
+#include <string.h>
+
+bool MemoryStorage::contains(uint16_t address, uint16_t length) const
+{
+    return data_ && address >= base_ && static_cast<uint32_t>(address - base_) + length <= size_;
+}
+
+bool MemoryStorage::read(uint16_t address, void *data, uint16_t length)
+{
+    if (!contains(address, length))
+    {
+        return false;
+    }
+    memcpy(data, data_ + (address - base_), length);
+    return true;
+}
+
+bool MemoryStorage::write(uint16_t address, const void *data, uint16_t length)
+{
+    if (!contains(address, length))
+    {
+        return false;
+    }
+    memcpy(data_ + (address - base_), data, length);
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef MEMORYSTORAGE_H
+#define MEMORYSTORAGE_H
+
+#include <Storage.h>
+
+//
+// MemoryStorage Class
+// Storage over a RAM buffer that mirrors the device range
+// [base, base + size). Used to parse records from an image prefetched in
+// the background, without touching the bus.
+//
+class MemoryStorage : public Storage {
+public:
+  MemoryStorage(uint8_t *data, uint16_t size, uint16_t base = 0)
+      : data_(data), size_(size), base_(base) {}
+
+  bool isAvailable() override { return data_ != nullptr; }
+  bool read(uint16_t address, void *data, uint16_t length) override;
+  bool write(uint16_t address, const void *data, uint16_t length) override;
+
+private:
+  bool contains(uint16_t address, uint16_t length) const;
+
+  uint8_t *data_;
+  uint16_t size_;
+  uint16_t base_;
+};
+
+#endif // MEMORYSTORAGE_H
@@ -0,0 +1,24 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <stdint.h>
+
+//
+// Storage Class
+// Byte-addressed persistent storage used for calibration and profile
+// records. Implementations return false when the device is missing or the
+// transfer failed, callers fall back to their defaults.
+//
+class Storage {
+public:
+  virtual ~Storage() {}
+
+  virtual bool isAvailable() = 0;
+  virtual bool read(uint16_t address, void *data, uint16_t length) = 0;
+  virtual bool write(uint16_t address, const void *data, uint16_t length) = 0;
+};
+
+// CRC-16/CCITT-FALSE a tarolt rekordok ellenorzesehez
+uint16_t storageCrc16(const void *data, uint16_t length, uint16_t crc = 0xFFFF);
+
+#endif // STORAGE_H
@@ -0,0 +1,103 @@
+"""PlatformIO post-build step: per-module static memory budget.
+
+Asks the linker for a map file and, after every link, prints how much
+static RAM (.data/.bss and the RAM-resident code in .time_critical and the
+scratch banks) and flash each module takes. Modules are the lib/ folders,
+src/ files and the framework archives. The runtime half (stack high-water
+mark, heap) is printed by the firmware with 'M' on the serial console.
+
+Can also be run by hand on an existing map file:
+
+    python3 scripts/memory_report.py .pio/build/pico/firmware.map
+"""
+
+import os
+import re
+import sys
+from collections import defaultdict
+
+RAM_SECTIONS = (".data", ".bss", "COMMON", ".time_critical", ".scratch_x",
+                ".scratch_y", ".uninitialized_data", ".noinit")
+FLASH_SECTIONS = (".text", ".rodata", ".data", ".time_critical", ".ARM")
+RAM_CODE_SECTIONS = (".time_critical", ".scratch_x", ".scratch_y")
+
+INLINE_RE = re.compile(r"^ (\.\S+|COMMON)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+NAME_RE = re.compile(r"^ (\.\S+|COMMON)\s*$")
+DETAIL_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+
+def module_name(obj):
+    """Map an input object path to a module name."""
+    obj = obj.replace("\\", "/")
+    archive = re.match(r"(.*/)?lib([^/]+)\.a\((.+)\)", obj)
+    if archive:
+        return archive.group(2)
+    if "/src/" in obj or obj.startswith("src/"):
+        return "src/" + os.path.basename(obj).replace(".o", "")
+    return os.path.basename(obj).replace(".o", "") or obj
+
+
+def input_sections(lines):
+    """Yield (section, address, size, object) for the linked input sections."""
+    in_map = False
+    pending = None
+    for line in lines:
+        if not in_map:
+            in_map = line.startswith("Linker script and memory map")
+            continue
+        match = INLINE_RE.match(line)
+        if match:
+            pending = None
+            yield match.group(1), int(match.group(2), 16), int(match.group(3), 16), match.group(4)
+            continue
+        match = NAME_RE.match(line)
+        if match:
+            pending = match.group(1)
+            continue
+        if pending:
+            match = DETAIL_RE.match(line)
+            if match:
+                yield pending, int(match.group(1), 16), int(match.group(2), 16), match.group(3)
+            pending = None
+
+
+def build_report(map_path):
+    with open(map_path, errors="replace") as f:
+        lines = f.readlines()
+
+    ram = defaultdict(int)
+    ram_code = defaultdict(int)
+    flash = defaultdict(int)
+    for section, address, size, obj in input_sections(lines):
+        if size == 0 or address == 0:
+            continue
+        module = module_name(obj.strip())
+        if section.startswith(RAM_SECTIONS):
+            ram[module] += size
+        if section.startswith(RAM_CODE_SECTIONS):
+            ram_code[module] += size
+        if section.startswith(FLASH_SECTIONS):
+            flash[module] += size
+
+    modules = sorted(set(ram) | set(flash), key=lambda m: (-ram[m], -flash[m]))
+    out = ["Static memory per module (bytes):",
+           "%-32s %10s %10s %10s" % ("module", "RAM", "RAM code", "flash")]
+    for module in modules:
+        out.append("%-32s %10d %10d %10d" % (module, ram[module], ram_code[module], flash[module]))
+    out.append("%-32s %10d %10d %10d" % ("TOTAL", sum(ram.values()),
+                                          sum(ram_code.values()), sum(flash.values())))
+    return "\n".join(out)
+
+
+def _post_link(source, target, env):
+    map_path = env.subst("$BUILD_DIR/${PROGNAME}.map")
+    if os.path.exists(map_path):
+        print(build_report(map_path))
+
+
+if __name__ == "__main__":
+    print(build_report(sys.argv[1]))
+else:
+    Import("env")  # noqa: F821 (provided by PlatformIO/SCons)
+    env.Append(LINKFLAGS=["-Wl,-Map,${BUILD_DIR}/${PROGNAME}.map"])  # noqa: F821
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", _post_link)  # noqa: F821
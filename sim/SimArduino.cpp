@@ -0,0 +1,88 @@
+//
+// Arduino API on the simulator's virtual clock: time, delays, GPIO and
+// Serial. Shared by the simulator (sim_main.cpp) and the host unit tests
+// in test/, which link it without the firmware's setup()/loop().
+//
+#include <Arduino.h>
+#include <hardware/timer.h>
+#include "SimHardware.h"
+
+unsigned long micros()
+{
+  return static_cast<unsigned long>(static_cast<uint32_t>(sim::now()));
+}
+
+unsigned long millis()
+{
+  return static_cast<unsigned long>(static_cast<uint32_t>(sim::now() / 1000));
+}
+
+void delay(unsigned long ms)
+{
+  sim::advance(static_cast<uint64_t>(ms) * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  sim::advance(us);
+}
+
+uint32_t time_us_32()
+{
+  return static_cast<uint32_t>(sim::now());
+}
+
+uint64_t time_us_64()
+{
+  return sim::now();
+}
+
+void pinMode(int pin, int mode)
+{
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(int pin, int value)
+{
+  static int ledState = -1;
+  if (pin == LED_BUILTIN && value != ledState)
+  {
+    ledState = value;
+    sim::metrics().ledToggles++;
+  }
+}
+
+long random()
+{
+  return sim::randomU32() & 0x7FFFFFFF;
+}
+
+long random(long max)
+{
+  return max > 0 ? random() % max : 0;
+}
+
+SimSerial Serial;
+
+size_t SimSerial::write(uint8_t c)
+{
+  sim::serialWrite(&c, 1);
+  return 1;
+}
+
+size_t SimSerial::write(const uint8_t *buffer, size_t size)
+{
+  sim::serialWrite(buffer, size);
+  return size;
+}
+
+int SimSerial::available()
+{
+  return sim::serialAvailable();
+}
+
+int SimSerial::read()
+{
+  return sim::serialRead();
+}
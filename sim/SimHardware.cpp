@@ -0,0 +1,695 @@
+#include "SimHardware.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+
+namespace sim
+{
+
+  static uint64_t clockUs = 0;
+  static Metrics simMetrics;
+  static uint32_t rngState = 0x12345678u;
+
+  uint64_t now()
+  {
+    return clockUs;
+  }
+
+  void advance(uint64_t us)
+  {
+    clockUs += us;
+  }
+
+  Metrics &metrics()
+  {
+    return simMetrics;
+  }
+
+  void setSeed(uint32_t seed)
+  {
+    rngState = seed ? seed : 1;
+  }
+
+  // xorshift32, determinisztikus
+  uint32_t randomU32()
+  {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+  }
+
+  static double randomUnit()
+  {
+    return (randomU32() & 0xFFFFFF) / double(0x1000000);
+  }
+
+  // ------------------------------------------------------------------ MCP3008
+
+  static const uint8_t ADC_CHANNELS = 8;
+  // 1 MHz SPI, 3 bajtos atvitel + CS kezeles
+  static const uint32_t ADC_READ_US = 30;
+  static Waveform waves[ADC_CHANNELS];
+
+  void setWaveform(uint8_t channel, const Waveform &wave)
+  {
+    if (channel < ADC_CHANNELS)
+    {
+      waves[channel] = wave;
+    }
+  }
+
+  // stream_decode.py CSV egy oszlopa; a timestamp_us 32 bites, az atfordulast kezeljuk
+  static bool loadTrace(const std::string &path, const std::string &column, Waveform &wave)
+  {
+    FILE *f = fopen(path.c_str(), "r");
+    if (!f)
+    {
+      return false;
+    }
+    char line[1024];
+    int timeIndex = -1;
+    int valueIndex = -1;
+    if (fgets(line, sizeof(line), f))
+    {
+      int index = 0;
+      for (char *tok = strtok(line, ",\r\n"); tok; tok = strtok(nullptr, ",\r\n"), ++index)
+      {
+        if (!strcmp(tok, "timestamp_us"))
+          timeIndex = index;
+        if (column == tok)
+          valueIndex = index;
+      }
+    }
+    wave.traceUs.clear();
+    wave.traceValues.clear();
+    uint32_t previous = 0;
+    uint64_t elapsed = 0;
+    while (timeIndex >= 0 && valueIndex >= 0 && fgets(line, sizeof(line), f))
+    {
+      long fields[32];
+      int count = 0;
+      for (char *tok = strtok(line, ",\r\n"); tok && count < 32; tok = strtok(nullptr, ",\r\n"))
+      {
+        fields[count++] = strtol(tok, nullptr, 10);
+      }
+      if (count <= timeIndex || count <= valueIndex)
+      {
+        continue;
+      }
+      uint32_t t = static_cast<uint32_t>(fields[timeIndex]);
+      if (wave.traceUs.empty())
+      {
+        previous = t;
+      }
+      elapsed += static_cast<uint32_t>(t - previous);
+      previous = t;
+      wave.traceUs.push_back(elapsed);
+      wave.traceValues.push_back(static_cast<uint16_t>(fields[valueIndex] & 0x3FF));
+    }
+    fclose(f);
+    wave.type = WAVE_TRACE;
+    return !wave.traceUs.empty();
+  }
+
+  static double traceValue(const Waveform &w)
+  {
+    // Linearis interpolacio a ket szomszedos minta kozott
+    uint64_t span = w.traceUs.back() + 1;
+    uint64_t t = clockUs % span;
+    size_t hi = std::upper_bound(w.traceUs.begin(), w.traceUs.end(), t) - w.traceUs.begin();
+    if (hi == 0 || hi >= w.traceUs.size())
+    {
+      return w.traceValues[hi == 0 ? 0 : w.traceValues.size() - 1];
+    }
+    size_t lo = hi - 1;
+    double f = double(t - w.traceUs[lo]) / double(w.traceUs[hi] - w.traceUs[lo]);
+    return w.traceValues[lo] + f * (double(w.traceValues[hi]) - w.traceValues[lo]);
+  }
+
+  bool parseWaveform(const std::string &spec, Waveform &wave)
+  {
+    if (spec.compare(0, 6, "trace,") == 0)
+    {
+      std::string rest = spec.substr(6);
+      size_t comma = rest.find(',');
+      std::string column = comma == std::string::npos ? "raw0" : rest.substr(comma + 1);
+      return loadTrace(rest.substr(0, comma), column, wave);
+    }
+
+    char type[16] = {0};
+    double values[5] = {1.0, 0.0, 512.0, 0.0, 0.0};
+    int n = sscanf(spec.c_str(), "%15[a-z],%lf,%lf,%lf,%lf,%lf", type,
+                   &values[0], &values[1], &values[2], &values[3], &values[4]);
+    if (n < 1)
+    {
+      return false;
+    }
+    if (!strcmp(type, "const"))
+    {
+      wave.type = WAVE_CONST;
+      // "const,value[,noise]"
+      wave.offset = n >= 2 ? values[0] : 512.0;
+      wave.noise = n >= 3 ? values[1] : 0.0;
+      wave.amplitude = 0.0;
+      return true;
+    }
+    if (!strcmp(type, "sine"))
+      wave.type = WAVE_SINE;
+    else if (!strcmp(type, "triangle"))
+      wave.type = WAVE_TRIANGLE;
+    else if (!strcmp(type, "square"))
+      wave.type = WAVE_SQUARE;
+    else
+      return false;
+    wave.periodS = values[0] > 0 ? values[0] : 1.0;
+    wave.amplitude = values[1];
+    wave.offset = values[2];
+    wave.noise = values[3];
+    wave.spikeRate = values[4];
+    return true;
+  }
+
+  static double rippleRelative = 0.0;
+  static double rippleHz = 100.0;
+
+  void setSupplyRipple(double relative, double hz)
+  {
+    rippleRelative = relative;
+    rippleHz = hz > 0 ? hz : 100.0;
+  }
+
+  // A csatorna feszultsege most, ADC countban; minden forras a tapbol jon, igy a ripple aranyosan hat ra
+  static double sampleChannel(uint8_t channel)
+  {
+    if (channel >= ADC_CHANNELS)
+    {
+      return 0.0;
+    }
+    const Waveform &w = waves[channel];
+    double phase = fmod(clockUs / 1e6 / w.periodS, 1.0);
+    double shape = 0.0;
+    switch (w.type)
+    {
+    case WAVE_CONST:
+      shape = 0.0;
+      break;
+    case WAVE_SINE:
+      shape = sin(2.0 * M_PI * phase);
+      break;
+    case WAVE_TRIANGLE:
+      shape = phase < 0.5 ? 4.0 * phase - 1.0 : 3.0 - 4.0 * phase;
+      break;
+    case WAVE_SQUARE:
+      shape = phase < 0.5 ? -1.0 : 1.0;
+      break;
+    case WAVE_TRACE:
+      break;
+    }
+    double v = w.type == WAVE_TRACE ? traceValue(w) : w.offset + w.amplitude * shape;
+    if (rippleRelative != 0.0)
+    {
+      v *= 1.0 + rippleRelative * sin(2.0 * M_PI * rippleHz * (clockUs / 1e6));
+    }
+    if (w.noise > 0.0)
+    {
+      v += (randomUnit() * 2.0 - 1.0) * w.noise;
+    }
+    if (w.spikeRate > 0.0 && randomUnit() < w.spikeRate)
+    {
+      v = (randomU32() & 1) ? 1023.0 : 0.0;
+    }
+    return v;
+  }
+
+  static uint16_t convert(double v)
+  {
+    advance(ADC_READ_US);
+    long rounded = lround(v);
+    return rounded < 0 ? 0 : (rounded > 1023 ? 1023 : rounded);
+  }
+
+  uint16_t adcRead(uint8_t channel)
+  {
+    if (channel == 0)
+    {
+      simMetrics.adcFrames++;
+      simMetrics.lastFrameStartUs = clockUs;
+    }
+    simMetrics.adcReads++;
+    return convert(sampleChannel(channel));
+  }
+
+  uint16_t adcReadDifference(uint8_t plus, uint8_t minus)
+  {
+    if (plus == 0)
+    {
+      simMetrics.adcFrames++;
+      simMetrics.lastFrameStartUs = clockUs;
+    }
+    simMetrics.adcReads++;
+    // Egy konverzio, a ket bemenet ugyanabban a pillanatban
+    return convert(sampleChannel(plus) - sampleChannel(minus));
+  }
+
+  // ------------------------------------------------------------------ I2C
+
+  static uint32_t i2cClockHz = 100000;
+  static bool i2cPresent[128] = {false};
+
+  void setI2CClock(uint32_t hz)
+  {
+    i2cClockHz = hz ? hz : 100000;
+  }
+
+  uint32_t i2cClock()
+  {
+    return i2cClockHz;
+  }
+
+  void setI2CDevicePresent(uint8_t address, bool present)
+  {
+    if (address < 128)
+    {
+      i2cPresent[address] = present;
+    }
+  }
+
+  // Busz ido: start + cim bajt + adat, 9 orajel bajtonkent (8 adat + ACK)
+  static void i2cBusTime(size_t bytes)
+  {
+    uint64_t us = ((bytes + 1) * 9ULL * 1000000ULL + i2cClockHz - 1) / i2cClockHz;
+    simMetrics.i2cBusyUs += us;
+    if (us > simMetrics.i2cLongestUs)
+    {
+      simMetrics.i2cLongestUs = static_cast<uint32_t>(us);
+    }
+    advance(us);
+  }
+
+  // 24LC64: 8 KB, 32 bajtos lapok, 5 ms iras ciklus, kozben NACK
+  static const uint16_t EEPROM_SIZE = 8192;
+  static const uint16_t EEPROM_PAGE = 32;
+  static const uint32_t EEPROM_WRITE_CYCLE_US = 5000;
+  static uint8_t eepromMemory[EEPROM_SIZE];
+  static bool eepromInitialised = false;
+  static uint16_t eepromPointer = 0;
+  static uint64_t eepromBusyUntil = 0;
+  static bool eepromDataNack = false;
+
+  void setEepromDataNack(bool nack)
+  {
+    eepromDataNack = nack;
+  }
+
+  static void eepromInit()
+  {
+    if (!eepromInitialised)
+    {
+      memset(eepromMemory, 0xFF, sizeof(eepromMemory)); // torolt allapot
+      eepromInitialised = true;
+    }
+  }
+
+  static uint8_t eepromWriteTransaction(const uint8_t *data, size_t length)
+  {
+    eepromInit();
+    if (clockUs < eepromBusyUntil)
+    {
+      simMetrics.eepromNacks++;
+      return 2; // iras ciklus alatt a chip nem ACK-zik
+    }
+    if (length >= 2)
+    {
+      eepromPointer = ((data[0] << 8) | data[1]) % EEPROM_SIZE;
+    }
+    if (length > 2 && eepromDataNack)
+    {
+      return 3;
+    }
+    if (length > 2)
+    {
+      // Lapon belul korbefordul, ahogy a chip
+      uint16_t pageStart = eepromPointer & ~(EEPROM_PAGE - 1);
+      for (size_t i = 2; i < length; ++i)
+      {
+        eepromMemory[eepromPointer] = data[i];
+        eepromPointer = pageStart | ((eepromPointer + 1) & (EEPROM_PAGE - 1));
+      }
+      eepromBusyUntil = clockUs + EEPROM_WRITE_CYCLE_US;
+      simMetrics.eepromWrites++;
+    }
+    return 0;
+  }
+
+  static size_t eepromReadTransaction(uint8_t *data, size_t length)
+  {
+    eepromInit();
+    if (clockUs < eepromBusyUntil)
+    {
+      simMetrics.eepromNacks++;
+      return 0;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+      data[i] = eepromMemory[eepromPointer];
+      eepromPointer = (eepromPointer + 1) % EEPROM_SIZE;
+    }
+    return length;
+  }
+
+  // SSD1306 128x64, horizontalis cimzes: 0x00 vezerlo bajt = parancsok, 0x40 = adat
+  static const uint16_t DISPLAY_WIDTH = 128;
+  static const uint16_t DISPLAY_PAGES = 8;
+  static uint8_t gddram[DISPLAY_PAGES * DISPLAY_WIDTH];
+  static uint8_t colStart = 0, colEnd = DISPLAY_WIDTH - 1, col = 0;
+  static uint8_t pageStart = 0, pageEnd = DISPLAY_PAGES - 1, page = 0;
+  static uint8_t pendingCommand = 0;
+  static uint8_t pendingArgs = 0;
+  static uint8_t commandArgs[2];
+
+  static void displayCommand(uint8_t byte)
+  {
+    if (pendingArgs)
+    {
+      commandArgs[2 - pendingArgs] = byte;
+      if (--pendingArgs == 0)
+      {
+        if (pendingCommand == 0x21)
+        {
+          colStart = col = commandArgs[0] % DISPLAY_WIDTH;
+          colEnd = commandArgs[1] % DISPLAY_WIDTH;
+        }
+        else if (pendingCommand == 0x22)
+        {
+          pageStart = page = commandArgs[0] % DISPLAY_PAGES;
+          pageEnd = commandArgs[1] % DISPLAY_PAGES;
+        }
+      }
+      return;
+    }
+    if (byte == 0x21 || byte == 0x22)
+    {
+      pendingCommand = byte;
+      pendingArgs = 2;
+    }
+  }
+
+  static void displayData(uint8_t byte)
+  {
+    gddram[page * DISPLAY_WIDTH + col] = byte;
+    simMetrics.displayBytes++;
+    if (col++ >= colEnd)
+    {
+      col = colStart;
+      page = page >= pageEnd ? pageStart : page + 1;
+    }
+  }
+
+  static uint8_t displayWriteTransaction(const uint8_t *data, size_t length)
+  {
+    if (length == 0)
+    {
+      return 0;
+    }
+    bool isData = data[0] & 0x40;
+    for (size_t i = 1; i < length; ++i)
+    {
+      if (isData)
+        displayData(data[i]);
+      else
+        displayCommand(data[i]);
+    }
+    return 0;
+  }
+
+  uint8_t i2cWrite(uint8_t address, const uint8_t *data, size_t length)
+  {
+    i2cBusTime(length);
+    if (address >= 128 || !i2cPresent[address])
+    {
+      return 2;
+    }
+    if (address == EEPROM_ADDRESS)
+    {
+      return eepromWriteTransaction(data, length);
+    }
+    if (address == DISPLAY_ADDRESS)
+    {
+      return displayWriteTransaction(data, length);
+    }
+    return 0;
+  }
+
+  size_t i2cRead(uint8_t address, uint8_t *data, size_t length)
+  {
+    i2cBusTime(length);
+    if (address >= 128 || !i2cPresent[address])
+    {
+      return 0;
+    }
+    if (address == EEPROM_ADDRESS)
+    {
+      return eepromReadTransaction(data, length);
+    }
+    memset(data, 0, length);
+    return length;
+  }
+
+  bool dumpDisplay(const std::string &path)
+  {
+    FILE *f = fopen(path.c_str(), "w");
+    if (!f)
+    {
+      return false;
+    }
+    // SSD1306 elrendezes: oldalankent 8 sor, bajtonkent egy oszlop
+    fprintf(f, "P1\n%u %u\n", DISPLAY_WIDTH, DISPLAY_PAGES * 8);
+    for (uint16_t y = 0; y < DISPLAY_PAGES * 8; ++y)
+    {
+      for (uint16_t x = 0; x < DISPLAY_WIDTH; ++x)
+      {
+        uint8_t byte = gddram[(y / 8) * DISPLAY_WIDTH + x];
+        fputc((byte >> (y & 7)) & 1 ? '1' : '0', f);
+        fputc(x + 1 < DISPLAY_WIDTH ? ' ' : '\n', f);
+      }
+    }
+    fclose(f);
+    return true;
+  }
+
+  // ------------------------------------------------------------------ QSPI flash
+
+  static const uint32_t FLASH_SECTOR = 4096;
+  static const uint32_t FLASH_PAGE = 256;
+  static const uint32_t FLASH_ERASE_US = 45000;
+  static const uint32_t FLASH_PAGE_US = 700;
+  static std::vector<uint8_t> flash(FLASH_SIZE, 0xFF);
+  static int32_t flashPagesLeft = -1;
+
+  const uint8_t *flashMemory()
+  {
+    return flash.data();
+  }
+
+  void setFlashPowerCut(int32_t pages)
+  {
+    flashPagesLeft = pages;
+  }
+
+  void flashErase(uint32_t offset, size_t length)
+  {
+    if (offset % FLASH_SECTOR || length % FLASH_SECTOR || offset + length > FLASH_SIZE)
+    {
+      fprintf(stderr, "sim: unaligned flash erase %u+%zu\n", offset, length);
+      abort();
+    }
+    advance(FLASH_ERASE_US * (length / FLASH_SECTOR));
+    if (flashPagesLeft == 0)
+    {
+      return;
+    }
+    simMetrics.flashErases += length / FLASH_SECTOR;
+    memset(&flash[offset], 0xFF, length);
+  }
+
+  void flashProgram(uint32_t offset, const uint8_t *data, size_t length)
+  {
+    if (offset % FLASH_PAGE || length % FLASH_PAGE || offset + length > FLASH_SIZE)
+    {
+      fprintf(stderr, "sim: unaligned flash program %u+%zu\n", offset, length);
+      abort();
+    }
+    for (size_t page = 0; page < length; page += FLASH_PAGE)
+    {
+      advance(FLASH_PAGE_US);
+      if (flashPagesLeft == 0)
+      {
+        return;
+      }
+      if (flashPagesLeft > 0)
+      {
+        flashPagesLeft--;
+      }
+      simMetrics.flashPages++;
+      for (size_t i = 0; i < FLASH_PAGE; ++i)
+      {
+        flash[offset + page + i] &= data[page + i];
+      }
+    }
+  }
+
+  bool loadFlash(const std::string &path)
+  {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f)
+    {
+      return false;
+    }
+    size_t n = fread(flash.data(), 1, flash.size(), f);
+    fclose(f);
+    return n == flash.size();
+  }
+
+  bool saveFlash(const std::string &path)
+  {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f)
+    {
+      return false;
+    }
+    size_t n = fwrite(flash.data(), 1, flash.size(), f);
+    fclose(f);
+    return n == flash.size();
+  }
+
+  // ------------------------------------------------------------------ USB HID
+
+  static uint32_t usbPollUs = 1000;
+
+  void usbSetPollInterval(uint32_t us)
+  {
+    usbPollUs = us ? us : 1000;
+  }
+
+  static uint64_t usbBusyUntil = 0; // az IN endpointon varo report atvetelenek ideje
+
+  // A report a kovetkezo host pollnal megy ki; ennek az ideje
+  static uint64_t usbQueue(const uint8_t *data, uint32_t length)
+  {
+    uint64_t poll = (clockUs / usbPollUs + 1) * usbPollUs;
+    usbBusyUntil = poll;
+
+    simMetrics.reports++;
+    simMetrics.reportBytes += length;
+    simMetrics.lastReport.assign(data, data + length);
+    simMetrics.latencyUs.push_back(static_cast<uint32_t>(poll - simMetrics.lastFrameStartUs));
+    return poll;
+  }
+
+  bool usbSend(const uint8_t *data, uint32_t length)
+  {
+    // Az elozo report atvetelet, majd a sajatjat varja ki
+    if (clockUs < usbBusyUntil)
+    {
+      clockUs = usbBusyUntil;
+    }
+    clockUs = usbQueue(data, length);
+    return true;
+  }
+
+  bool usbSendNb(const uint8_t *data, uint32_t length)
+  {
+    if (clockUs < usbBusyUntil)
+    {
+      return false;
+    }
+    usbQueue(data, length);
+    return true;
+  }
+
+  // ------------------------------------------------------------------ Serial
+
+  struct SerialInput
+  {
+    uint64_t atUs;
+    std::string text;
+  };
+  static std::deque<SerialInput> serialInputs;
+  static std::string serialRx;
+  static FILE *serialOut = nullptr;
+  static bool serialEcho = false;
+  static bool serialLineStart = true;
+
+  void setSerialOutput(const std::string &path, bool echo)
+  {
+    if (!path.empty())
+    {
+      serialOut = fopen(path.c_str(), "wb");
+    }
+    serialEcho = echo;
+  }
+
+  void serialWrite(const uint8_t *data, size_t length)
+  {
+    if (serialOut)
+    {
+      fwrite(data, 1, length, serialOut);
+    }
+    if (serialEcho)
+    {
+      for (size_t i = 0; i < length; ++i)
+      {
+        if (serialLineStart)
+        {
+          fprintf(stderr, "[%10.6f] ", clockUs / 1e6);
+          serialLineStart = false;
+        }
+        fputc(data[i], stderr);
+        serialLineStart = data[i] == '\n';
+      }
+    }
+  }
+
+  void scheduleSerialInput(uint64_t atUs, const std::string &text)
+  {
+    // Idorendben tartjuk a sort
+    auto it = serialInputs.begin();
+    while (it != serialInputs.end() && it->atUs <= atUs)
+    {
+      ++it;
+    }
+    serialInputs.insert(it, SerialInput{atUs, text});
+  }
+
+  static void pumpSerialInput()
+  {
+    while (!serialInputs.empty() && serialInputs.front().atUs <= clockUs)
+    {
+      serialRx += serialInputs.front().text;
+      serialInputs.pop_front();
+    }
+  }
+
+  int serialAvailable()
+  {
+    pumpSerialInput();
+    return static_cast<int>(serialRx.size());
+  }
+
+  int serialRead()
+  {
+    pumpSerialInput();
+    if (serialRx.empty())
+    {
+      return -1;
+    }
+    int c = static_cast<uint8_t>(serialRx[0]);
+    serialRx.erase(0, 1);
+    return c;
+  }
+
+}
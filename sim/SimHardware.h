@@ -0,0 +1,123 @@
+#ifndef SIMHARDWARE_H
+#define SIMHARDWARE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+//
+// Simulated hardware for running the firmware on Linux.
+// Everything runs on one virtual clock: the firmware only sees time move
+// when a simulated peripheral costs time (SPI/I2C transfers, EEPROM write
+// cycles, blocking HID sends waiting for the host poll) or when it sleeps.
+//
+namespace sim
+{
+
+  // Virtual clock, mikroszekundumban
+  uint64_t now();
+  void advance(uint64_t us);
+
+  // --- MCP3008: scriptelt jelalakok csatornankent ---
+  enum WaveType : uint8_t
+  {
+    WAVE_CONST,
+    WAVE_SINE,
+    WAVE_TRIANGLE,
+    WAVE_SQUARE,
+    WAVE_TRACE // rogzitett minta (tools/stream_decode.py CSV), korbe jatszva
+  };
+
+  struct Waveform
+  {
+    WaveType type = WAVE_CONST;
+    double periodS = 1.0;    // periodus masodpercben
+    double amplitude = 0.0;  // ADC count
+    double offset = 512.0;   // ADC count
+    double noise = 0.0;      // egyenletes zaj +-noise count
+    double spikeRate = 0.0;  // tuskek aranya mintankent (0..1)
+    std::vector<uint64_t> traceUs;      // WAVE_TRACE: idobelyegek az elso sortol
+    std::vector<uint16_t> traceValues;  // WAVE_TRACE: ADC ertekek
+  };
+
+  void setWaveform(uint8_t channel, const Waveform &wave);
+  // Parse "sine,period,amplitude,offset[,noise[,spikeRate]]", "const,value[,noise]"
+  // or "trace,samples.csv[,column]" (column defaults to raw0)
+  bool parseWaveform(const std::string &spec, Waveform &wave);
+  uint16_t adcRead(uint8_t channel);
+  // Pseudo-differencialis konverzio (IN+ - IN-), 0-nal levagva, mint a chip
+  uint16_t adcReadDifference(uint8_t plus, uint8_t minus);
+  // Tap ripple: minden csatorna (1 + relative * sin(2 pi hz t))-szerese (aranyos forrasok)
+  void setSupplyRipple(double relative, double hz);
+
+  // --- I2C busz es eszkozok ---
+  // Tranzakcio szintu modellek: 24LC64 EEPROM (0x50) es SSD1306 (0x3C).
+  // A visszateresi ertek a Wire endTransmission() kodja: 0 ok, 2 cim NACK.
+  const uint8_t EEPROM_ADDRESS = 0x50;
+  const uint8_t DISPLAY_ADDRESS = 0x3C;
+
+  void setI2CClock(uint32_t hz);
+  uint32_t i2cClock();
+  void setI2CDevicePresent(uint8_t address, bool present);
+  // Hibas EEPROM: a cimet ACK-zza, de minden iras adat bajtjait NACK-zza (endTransmission 3)
+  void setEepromDataNack(bool nack);
+  uint8_t i2cWrite(uint8_t address, const uint8_t *data, size_t length);
+  size_t i2cRead(uint8_t address, uint8_t *data, size_t length);
+
+  // SSD1306 GDDRAM mentese PBM kepkent
+  bool dumpDisplay(const std::string &path);
+
+  // --- QSPI flash (XIP) ---
+  // NOR flash: torles 0xFF-re, programozas csak 1 -> 0 biteket ir; torles ~45 ms, lap ~0.7 ms
+  const uint32_t FLASH_SIZE = 2 * 1024 * 1024;
+  const uint8_t *flashMemory();
+  void flashErase(uint32_t offset, size_t length);
+  void flashProgram(uint32_t offset, const uint8_t *data, size_t length);
+  bool loadFlash(const std::string &path);
+  bool saveFlash(const std::string &path);
+  // Aramszunet: ennyi flash lap programozasa utan minden tovabbi torles / iras elveszik (-1 = nincs)
+  void setFlashPowerCut(int32_t pages);
+
+  // --- USB HID: report naplo, a host 1 ms-onkent kerdez ---
+  void usbSetPollInterval(uint32_t us);
+  // Blokkol a kovetkezo host pollig, ugy mint a mbed USBHID::send()
+  bool usbSend(const uint8_t *data, uint32_t length);
+  // Mint a mbed USBHID::send_nb(): azonnal visszater; false, ha az endpointon meg ott var
+  // az elozo report (a host a kovetkezo pollnal veszi at)
+  bool usbSendNb(const uint8_t *data, uint32_t length);
+
+  // --- Serial ---
+  void serialWrite(const uint8_t *data, size_t length);
+  void scheduleSerialInput(uint64_t atUs, const std::string &text);
+  int serialAvailable();
+  int serialRead();
+  void setSerialOutput(const std::string &path, bool echo);
+
+  // --- Metrikak ---
+  struct Metrics
+  {
+    uint64_t adcFrames = 0;        // teljes 8 csatornas olvasasok (0. csatorna olvasasa)
+    uint64_t adcReads = 0;
+    uint64_t reports = 0;
+    uint64_t reportBytes = 0;
+    uint64_t lastFrameStartUs = 0;
+    std::vector<uint32_t> latencyUs; // host altali atvetel - a legutolso ADC frame kezdete
+    std::vector<uint8_t> lastReport; // utolso elkuldott HID report (report ID-vel)
+    uint64_t displayBytes = 0;
+    uint64_t eepromWrites = 0;     // EEPROM lap irasok
+    uint64_t eepromNacks = 0;      // iras kozbeni (ACK polling) NACK-ok
+    uint64_t i2cBusyUs = 0;        // osszes busz ido
+    uint32_t i2cLongestUs = 0;     // leghosszabb egyetlen tranzakcio
+    uint64_t ledToggles = 0;
+    uint64_t flashErases = 0;      // szektor torlesek
+    uint64_t flashPages = 0;       // programozott lapok
+  };
+  Metrics &metrics();
+
+  void setSeed(uint32_t seed);
+  uint32_t randomU32();
+
+}
+
+#endif // SIMHARDWARE_H
@@ -0,0 +1,245 @@
+//
+// Linux simulator entry point.
+// Runs the unmodified firmware (src/main.cpp setup()/loop()) against the
+// simulated MCP3008, I2C devices, USB host and Serial on a virtual clock,
+// then prints sample rate, report rate, latency percentiles, boot time and
+// scheduler deadline misses. Runs are deterministic for a given seed.
+//
+#include <Arduino.h>
+#include <Scheduler.h>
+#include "SimHardware.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+// A firmware (src/main.cpp)
+void setup();
+void loop();
+extern Scheduler scheduler;
+extern uint32_t firstReportUs;
+
+// ------------------------------------------------------------------- main
+
+static void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  --seconds N          virtual run time (default 10)\n"
+          "  --wave CH=SPEC       channel waveform, SPEC is\n"
+          "                       sine|triangle|square,period_s,amplitude,offset[,noise[,spike_rate]]\n"
+          "                       or const,value[,noise]\n"
+          "                       or trace,samples.csv[,column] (stream_decode.py output, default raw0)\n"
+          "  --ripple REL,HZ       supply ripple, every channel scaled by 1 + REL * sin(2 pi HZ t)\n"
+          "  --cmd T_MS:TEXT      send TEXT over Serial at T_MS virtual ms (repeatable)\n"
+          "  --loop-us N          CPU time charged for every loop() pass (default 0)\n"
+          "  --poll-us N          USB host poll interval (default 1000)\n"
+          "  --no-eeprom          leave the 24LC64 off the bus\n"
+          "  --no-display         leave the SSD1306 off the bus\n"
+          "  --serial-out PATH    write firmware Serial output to PATH\n"
+          "  --verbose            echo firmware Serial output to stderr\n"
+          "  --display-dump PATH  save the final display contents as PBM\n"
+          "  --flash PATH         QSPI flash image, loaded if present and saved at exit\n"
+          "  --flash-cut N        power loss after N flash pages (later erases and writes are lost)\n"
+          "  --seed N             noise generator seed (default 1)\n",
+          prog);
+}
+
+static uint32_t percentile(std::vector<uint32_t> &sorted, double p)
+{
+  if (sorted.empty())
+  {
+    return 0;
+  }
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+static void setDefaultWaves()
+{
+  // Pedalok lassu szinusz, gaz haromszog, tobbi csatorna allando zajjal
+  const char *defaults[8] = {
+      "sine,2.0,400,512,2",
+      "sine,3.0,400,512,2",
+      "sine,5.0,300,512,2,0.001",
+      "const,0,1",
+      "triangle,4.0,500,512,3",
+      "const,0,1",
+      "const,0,1",
+      "const,0,1",
+  };
+  for (uint8_t ch = 0; ch < 8; ++ch)
+  {
+    sim::Waveform wave;
+    sim::parseWaveform(defaults[ch], wave);
+    sim::setWaveform(ch, wave);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  double seconds = 10.0;
+  uint32_t loopCostUs = 0;
+  bool verbose = false;
+  std::string serialOut;
+  std::string displayDump;
+  std::string flashImage;
+
+  setDefaultWaves();
+  sim::setSeed(1);
+  sim::setI2CDevicePresent(sim::EEPROM_ADDRESS, true);
+  sim::setI2CDevicePresent(sim::DISPLAY_ADDRESS, true);
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--seconds" && hasValue)
+    {
+      seconds = atof(argv[++i]);
+    }
+    else if (arg == "--wave" && hasValue)
+    {
+      std::string spec = argv[++i];
+      size_t eq = spec.find('=');
+      sim::Waveform wave;
+      int ch = eq == std::string::npos ? -1 : atoi(spec.substr(0, eq).c_str());
+      if (ch < 0 || ch > 7 || !sim::parseWaveform(spec.substr(eq + 1), wave))
+      {
+        fprintf(stderr, "bad --wave '%s'\n", spec.c_str());
+        return 2;
+      }
+      sim::setWaveform(ch, wave);
+    }
+    else if (arg == "--ripple" && hasValue)
+    {
+      double relative = 0.0;
+      double hz = 0.0;
+      if (sscanf(argv[++i], "%lf,%lf", &relative, &hz) != 2)
+      {
+        fprintf(stderr, "bad --ripple '%s'\n", argv[i]);
+        return 2;
+      }
+      sim::setSupplyRipple(relative, hz);
+    }
+    else if (arg == "--cmd" && hasValue)
+    {
+      std::string spec = argv[++i];
+      size_t colon = spec.find(':');
+      if (colon == std::string::npos)
+      {
+        fprintf(stderr, "bad --cmd '%s'\n", spec.c_str());
+        return 2;
+      }
+      sim::scheduleSerialInput(static_cast<uint64_t>(atof(spec.substr(0, colon).c_str()) * 1000),
+                               spec.substr(colon + 1));
+    }
+    else if (arg == "--loop-us" && hasValue)
+    {
+      loopCostUs = atoi(argv[++i]);
+    }
+    else if (arg == "--poll-us" && hasValue)
+    {
+      sim::usbSetPollInterval(atoi(argv[++i]));
+    }
+    else if (arg == "--no-eeprom")
+    {
+      sim::setI2CDevicePresent(sim::EEPROM_ADDRESS, false);
+    }
+    else if (arg == "--no-display")
+    {
+      sim::setI2CDevicePresent(sim::DISPLAY_ADDRESS, false);
+    }
+    else if (arg == "--serial-out" && hasValue)
+    {
+      serialOut = argv[++i];
+    }
+    else if (arg == "--verbose")
+    {
+      verbose = true;
+    }
+    else if (arg == "--display-dump" && hasValue)
+    {
+      displayDump = argv[++i];
+    }
+    else if (arg == "--flash" && hasValue)
+    {
+      flashImage = argv[++i];
+      sim::loadFlash(flashImage);
+    }
+    else if (arg == "--flash-cut" && hasValue)
+    {
+      sim::setFlashPowerCut(atoi(argv[++i]));
+    }
+    else if (arg == "--seed" && hasValue)
+    {
+      sim::setSeed(strtoul(argv[++i], nullptr, 0));
+    }
+    else
+    {
+      usage(argv[0]);
+      return arg == "--help" ? 0 : 2;
+    }
+  }
+  sim::setSerialOutput(serialOut, verbose);
+
+  const uint64_t endUs = static_cast<uint64_t>(seconds * 1e6);
+  auto wallStart = std::chrono::steady_clock::now();
+
+  setup();
+  while (sim::now() < endUs)
+  {
+    loop();
+    sim::advance(loopCostUs);
+  }
+
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  double simS = sim::now() / 1e6;
+  sim::Metrics &m = sim::metrics();
+
+  std::vector<uint32_t> latency = m.latencyUs;
+  std::sort(latency.begin(), latency.end());
+
+  uint32_t overruns = 0;
+  uint32_t skipped = 0;
+  for (uint8_t i = 0; i < scheduler.taskCount(); ++i)
+  {
+    overruns += scheduler.task(i).stats.overruns;
+    skipped += scheduler.task(i).stats.skipped;
+  }
+
+  printf("virtual time        %.3f s (wall %.3f s, %.0fx)\n", simS, wallS, wallS > 0 ? simS / wallS : 0.0);
+  printf("sample rate         %.1f frames/s (%llu channel reads)\n", m.adcFrames / simS,
+         (unsigned long long)m.adcReads);
+  printf("report rate         %.1f reports/s (%llu bytes)\n", m.reports / simS,
+         (unsigned long long)m.reportBytes);
+  printf("latency us          p50 %u  p90 %u  p99 %u  max %u\n", percentile(latency, 0.50),
+         percentile(latency, 0.90), percentile(latency, 0.99), latency.empty() ? 0 : latency.back());
+  printf("first report        %u us\n", firstReportUs);
+  printf("deadline misses     %u overruns, %u skipped periods\n", overruns, skipped);
+  printf("i2c                 busy %llu us, longest %u us, display %llu bytes, eeprom %llu pages / %llu nacks\n",
+         (unsigned long long)m.i2cBusyUs, m.i2cLongestUs, (unsigned long long)m.displayBytes,
+         (unsigned long long)m.eepromWrites, (unsigned long long)m.eepromNacks);
+  printf("flash               %llu sector erases, %llu pages\n", (unsigned long long)m.flashErases,
+         (unsigned long long)m.flashPages);
+  printf("led toggles         %llu\n", (unsigned long long)m.ledToggles);
+
+  // Taskonkenti bontas ugyanabban a formatumban, mint a konzol 'S' parancsa
+  struct StdoutPrint : Print
+  {
+    size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); }
+  } out;
+  scheduler.printStats(out);
+
+  if (!displayDump.empty() && !sim::dumpDisplay(displayDump))
+  {
+    fprintf(stderr, "cannot write %s\n", displayDump.c_str());
+  }
+  if (!flashImage.empty() && !sim::saveFlash(flashImage))
+  {
+    fprintf(stderr, "cannot write %s\n", flashImage.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+#ifndef SIM_ADAFRUIT_GFX_H
+#define SIM_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+// Adafruit_GFX stand-in: pixel, line and rectangle primitives; text only
+// moves the cursor (no font rendering in the simulator)
+class Adafruit_GFX : public Print
+{
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    for (int16_t i = 0; i < w; ++i)
+      drawPixel(x + i, y, color);
+  }
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    for (int16_t i = 0; i < h; ++i)
+      drawPixel(x, y + i, color);
+  }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    for (int16_t i = 0; i < h; ++i)
+      drawFastHLine(x, y + i, w, color);
+  }
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+  void setCursor(int16_t x, int16_t y)
+  {
+    cursor_x = x;
+    cursor_y = y;
+  }
+  void setTextSize(uint8_t s) { textsize = s ? s : 1; }
+  void setTextColor(uint16_t c) { textcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; (void)bg; }
+
+  size_t write(uint8_t c) override
+  {
+    if (c == '\n')
+    {
+      cursor_x = 0;
+      cursor_y += 8 * textsize;
+    }
+    else if (c != '\r')
+    {
+      cursor_x += 6 * textsize;
+    }
+    return 1;
+  }
+  using Print::write;
+
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+protected:
+  int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  int16_t cursor_x = 0, cursor_y = 0;
+  uint16_t textcolor = 1;
+  uint8_t textsize = 1;
+};
+
+#endif
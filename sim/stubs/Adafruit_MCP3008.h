@@ -0,0 +1,21 @@
+#ifndef SIM_ADAFRUIT_MCP3008_H
+#define SIM_ADAFRUIT_MCP3008_H
+
+#include <Arduino.h>
+#include "../SimHardware.h"
+
+// MCP3008: a csatornak a sim::setWaveform() jelalakjait adjak
+class Adafruit_MCP3008
+{
+public:
+  bool begin(uint8_t cs = 10) { (void)cs; return true; }
+  int readADC(uint8_t channel) { return sim::adcRead(channel); }
+  // Pseudo-differencialis par: (IN+ - IN-), 0-nal levagva, mint a chip
+  int readADCDifference(uint8_t differential)
+  {
+    uint8_t plus = differential & 0x07;
+    return sim::adcReadDifference(plus, plus ^ 1);
+  }
+};
+
+#endif
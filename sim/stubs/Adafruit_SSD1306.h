@@ -0,0 +1,125 @@
+#ifndef SIM_ADAFRUIT_SSD1306_H
+#define SIM_ADAFRUIT_SSD1306_H
+
+// Adafruit_SSD1306 stand-in: same buffer handling (malloc in begin() only
+// when no buffer is set) and the same I2C traffic for display()
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_EXTERNALVCC 0x01
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_DISPLAYOFF 0xAE
+
+class Adafruit_SSD1306 : public Adafruit_GFX
+{
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi = &DefaultWire(), int8_t rst_pin = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL)
+      : Adafruit_GFX(w, h), wire(twi), wireClk(clkDuring), restoreClk(clkAfter)
+  {
+    (void)rst_pin;
+  }
+
+  ~Adafruit_SSD1306()
+  {
+    if (buffer)
+    {
+      free(buffer);
+      buffer = NULL;
+    }
+  }
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0, bool reset = true, bool periphBegin = true)
+  {
+    (void)switchvcc;
+    (void)reset;
+    (void)periphBegin;
+    if ((!buffer) && !(buffer = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8))))
+      return false;
+    clearDisplay();
+    i2caddr_ = i2caddr ? i2caddr : 0x3C;
+
+    // Init parancssorozat (hossz az eredetivel egyezik, a tartalom nem szamit)
+    static const uint8_t init[] = {0xAE, 0xD5, 0x80, 0xA8, 0x3F, 0xD3, 0x00, 0x40, 0x8D, 0x14,
+                                   0x20, 0x00, 0xA1, 0xC8, 0xDA, 0x12, 0x81, 0xCF, 0xD9, 0xF1,
+                                   0xDB, 0x40, 0xA4, 0xA6, 0x2E, 0xAF};
+    if (wireClk)
+      wire->setClock(wireClk);
+    sendCommands(init, sizeof(init));
+    if (restoreClk)
+      wire->setClock(restoreClk);
+    return true; // az eredeti sem ellenorzi az ACK-ot
+  }
+
+  void display()
+  {
+    static const uint8_t window[] = {SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, 127};
+    if (wireClk)
+      wire->setClock(wireClk);
+    sendCommands(window, sizeof(window));
+    uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+    uint8_t *ptr = buffer;
+    while (count)
+    {
+      uint16_t chunk = count > 31 ? 31 : count;
+      wire->beginTransmission(i2caddr_);
+      wire->write((uint8_t)0x40);
+      wire->write(ptr, chunk);
+      wire->endTransmission();
+      ptr += chunk;
+      count -= chunk;
+    }
+    if (restoreClk)
+      wire->setClock(restoreClk);
+  }
+
+  void clearDisplay() { memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8)); }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT || !buffer)
+      return;
+    uint8_t &b = buffer[x + (y / 8) * WIDTH];
+    uint8_t mask = 1 << (y & 7);
+    if (color == SSD1306_WHITE)
+      b |= mask;
+    else if (color == SSD1306_BLACK)
+      b &= ~mask;
+    else
+      b ^= mask;
+  }
+
+  uint8_t *getBuffer() { return buffer; }
+
+  void ssd1306_command(uint8_t c) { sendCommands(&c, 1); }
+
+protected:
+  static TwoWire &DefaultWire()
+  {
+    static TwoWire w(0, 0);
+    return w;
+  }
+
+  void sendCommands(const uint8_t *c, uint8_t n)
+  {
+    wire->beginTransmission(i2caddr_);
+    wire->write((uint8_t)0x00);
+    wire->write(c, n);
+    wire->endTransmission();
+  }
+
+  TwoWire *wire;
+  uint8_t *buffer = NULL;
+  uint8_t i2caddr_ = 0x3C;
+  uint32_t wireClk;
+  uint32_t restoreClk;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// Arduino API stand-in for the Linux simulator (only what the firmware uses)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+
+typedef uint8_t byte;
+typedef unsigned int uint;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define LED_BUILTIN 25
+#define DEC 10
+#define HEX 16
+#define B00000001 1
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#ifndef LSB
+#define LSB(n) ((n) & 0xff)
+#endif
+#ifndef MSB
+#define MSB(n) (((n) & 0xff00) >> 8)
+#endif
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+long random();
+long random(long max);
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+class String
+{
+public:
+  String() {}
+  String(const char *s) : s_(s ? s : "") {}
+  String(const std::string &s) : s_(s) {}
+  String(char c) : s_(1, c) {}
+  String(int v) : s_(std::to_string(v)) {}
+  String(unsigned int v) : s_(std::to_string(v)) {}
+  String(long v) : s_(std::to_string(v)) {}
+  String(unsigned long v) : s_(std::to_string(v)) {}
+  String(double v, int decimals = 2)
+  {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    s_ = buf;
+  }
+
+  const char *c_str() const { return s_.c_str(); }
+  unsigned int length() const { return s_.size(); }
+
+  String &operator+=(const String &o)
+  {
+    s_ += o.s_;
+    return *this;
+  }
+  friend String operator+(const String &a, const String &b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String &a, const char *b) { return String(a.s_ + b); }
+  friend String operator+(const char *a, const String &b) { return String(a + b.s_); }
+
+private:
+  std::string s_;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      write(buffer[i]);
+    return size;
+  }
+  virtual int availableForWrite() { return 0; }
+
+  size_t print(const char *s) { return write(reinterpret_cast<const uint8_t *>(s), strlen(s)); }
+  size_t print(const String &s) { return print(s.c_str()); }
+  size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(unsigned char v, int base = DEC) { return print(static_cast<unsigned long>(v), base); }
+  size_t print(int v, int base = DEC) { return print(static_cast<long>(v), base); }
+  size_t print(unsigned int v, int base = DEC) { return print(static_cast<unsigned long>(v), base); }
+  size_t print(long v, int base = DEC) { return printNumber(v < 0 ? "-" : "", v < 0 ? -(unsigned long long)v : v, base); }
+  size_t print(unsigned long v, int base = DEC) { return printNumber("", v, base); }
+  size_t print(long long v, int base = DEC) { return printNumber(v < 0 ? "-" : "", v < 0 ? -(unsigned long long)v : v, base); }
+  size_t print(unsigned long long v, int base = DEC) { return printNumber("", v, base); }
+  size_t print(double v, int decimals = 2) { return print(String(v, decimals)); }
+
+  size_t println() { return print("\r\n"); }
+  template <typename T>
+  size_t println(T v) { return print(v) + println(); }
+  template <typename T>
+  size_t println(T v, int format) { return print(v, format) + println(); }
+
+private:
+  size_t printNumber(const char *sign, unsigned long long v, int base)
+  {
+    char buf[72];
+    snprintf(buf, sizeof(buf), base == HEX ? "%s%llX" : "%s%llu", sign, v);
+    return print(buf);
+  }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() { return -1; }
+  virtual void flush() {}
+};
+
+// USB CDC Serial: kimenet fajlba/stderr-re, bemenet idozitett parancsokbol
+class SimSerial : public Stream
+{
+public:
+  void begin(unsigned long) { begun_ = true; }
+  void end() { begun_ = false; }
+  explicit operator bool() const { return begun_; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  int availableForWrite() override { return 4096; }
+  int available() override;
+  int read() override;
+
+private:
+  bool begun_ = false;
+};
+
+extern SimSerial Serial;
+
+namespace arduino
+{
+}
+using namespace arduino;
+
+#endif // SIM_ARDUINO_H
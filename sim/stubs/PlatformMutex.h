@@ -0,0 +1,11 @@
+#ifndef SIM_PLATFORMMUTEX_H
+#define SIM_PLATFORMMUTEX_H
+
+class PlatformMutex
+{
+public:
+  void lock() {}
+  void unlock() {}
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SIM_PLUGGABLEUSBHID_H
+#define SIM_PLUGGABLEUSBHID_H
+
+// mbed/Arduino USBHID stand-in: send() logs the report and blocks until the
+// next simulated host poll, like the blocking mbed implementation; send_nb()
+// fails while the previous report still waits on the endpoint
+
+#include <Arduino.h>
+#include "usb_phy_api.h"
+#include "../SimHardware.h"
+
+#define MAX_HID_REPORT_SIZE (64)
+
+#define CONFIGURATION_DESCRIPTOR_LENGTH (0x09)
+#define INTERFACE_DESCRIPTOR_LENGTH (0x09)
+#define ENDPOINT_DESCRIPTOR_LENGTH (0x07)
+#define HID_DESCRIPTOR_LENGTH (0x09)
+#define CONFIGURATION_DESCRIPTOR (2)
+#define INTERFACE_DESCRIPTOR (4)
+#define ENDPOINT_DESCRIPTOR (5)
+#define HID_DESCRIPTOR (0x21)
+#define REPORT_DESCRIPTOR (0x22)
+#define HID_CLASS (3)
+#define HID_SUBCLASS_NONE (0)
+#define HID_SUBCLASS_BOOT (1)
+#define HID_PROTOCOL_NONE (0)
+#define HID_PROTOCOL_KEYBOARD (1)
+#define HID_VERSION_1_11 (0x0111)
+#define C_RESERVED (1U << 7)
+#define C_SELF_POWERED (1U << 6)
+#define C_POWER(mA) ((mA) / 2)
+#define E_INTERRUPT (0x03)
+#define MBED_ASSERT(expr) ((void)0)
+
+typedef struct
+{
+  uint32_t length;
+  uint8_t data[MAX_HID_REPORT_SIZE];
+} HID_REPORT;
+
+namespace arduino
+{
+
+  class USBHID
+  {
+  public:
+    USBHID(USBPhy *phy, uint8_t output_report_length, uint8_t input_report_length,
+           uint16_t vendor_id, uint16_t product_id, uint16_t product_release)
+    {
+      (void)phy;
+      (void)output_report_length;
+      (void)input_report_length;
+      (void)vendor_id;
+      (void)product_id;
+      (void)product_release;
+    }
+    virtual ~USBHID() {}
+
+    bool send(const HID_REPORT *report) { return sim::usbSend(report->data, report->length); }
+    bool send_nb(const HID_REPORT *report) { return sim::usbSendNb(report->data, report->length); }
+    bool configured() { return true; }
+
+    virtual const uint8_t *report_desc() = 0;
+    uint16_t report_desc_length()
+    {
+      report_desc();
+      return reportLength;
+    }
+
+  protected:
+    virtual const uint8_t *configuration_desc(uint8_t index) = 0;
+
+    uint16_t reportLength = 0;
+    uint8_t _int_in = 0x81;
+    uint8_t _int_out = 0x01;
+  };
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include <Arduino.h>
+#include "../SimHardware.h"
+
+namespace arduino
+{
+
+  // MbedI2C a szimulalt I2C buszon (sim::i2cWrite / sim::i2cRead)
+  class MbedI2C : public Stream
+  {
+  public:
+    MbedI2C(int sda, int scl) { (void)sda; (void)scl; }
+
+    void begin() {}
+    void end() {}
+    void setClock(uint32_t freq) { sim::setI2CClock(freq); }
+
+    void beginTransmission(uint8_t address)
+    {
+      address_ = address;
+      txLength_ = 0;
+    }
+
+    uint8_t endTransmission(bool stopBit = true)
+    {
+      (void)stopBit;
+      return sim::i2cWrite(address_, txBuffer_, txLength_);
+    }
+
+    size_t requestFrom(uint8_t address, size_t len, bool stopBit = true)
+    {
+      (void)stopBit;
+      if (len > sizeof(rxBuffer_))
+        len = sizeof(rxBuffer_);
+      rxLength_ = sim::i2cRead(address, rxBuffer_, len);
+      rxIndex_ = 0;
+      return rxLength_;
+    }
+
+    size_t write(uint8_t data) override
+    {
+      if (txLength_ >= sizeof(txBuffer_))
+        return 0;
+      txBuffer_[txLength_++] = data;
+      return 1;
+    }
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      size_t n = 0;
+      while (n < len && write(data[n]))
+        ++n;
+      return n;
+    }
+
+    int available() override { return rxLength_ - rxIndex_; }
+    int read() override { return rxIndex_ < rxLength_ ? rxBuffer_[rxIndex_++] : -1; }
+    int peek() override { return rxIndex_ < rxLength_ ? rxBuffer_[rxIndex_] : -1; }
+
+  private:
+    uint8_t address_ = 0;
+    uint8_t txBuffer_[256];
+    size_t txLength_ = 0;
+    uint8_t rxBuffer_[256];
+    size_t rxLength_ = 0;
+    size_t rxIndex_ = 0;
+  };
+
+}
+
+typedef arduino::MbedI2C TwoWire;
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef SIM_HARDWARE_FLASH_H
+#define SIM_HARDWARE_FLASH_H
+
+#include <stdint.h>
+#include "../../SimHardware.h"
+
+// RP2040 QSPI flash: az XIP terulet a szimulalt flash tartalma
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+#define XIP_BASE (reinterpret_cast<uintptr_t>(sim::flashMemory()))
+
+inline void flash_range_erase(uint32_t flash_offs, size_t count) { sim::flashErase(flash_offs, count); }
+inline void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count)
+{
+  sim::flashProgram(flash_offs, data, count);
+}
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef SIM_HARDWARE_SYNC_H
+#define SIM_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+// Egy mag, megszakitasok nelkul: a tiltas ures
+inline uint32_t save_and_disable_interrupts() { return 0; }
+inline void restore_interrupts(uint32_t status) { (void)status; }
+
+#endif
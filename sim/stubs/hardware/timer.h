@@ -0,0 +1,10 @@
+#ifndef SIM_HARDWARE_TIMER_H
+#define SIM_HARDWARE_TIMER_H
+
+#include <stdint.h>
+
+// RP2040 mikroszekundum timer a virtualis orarol
+uint32_t time_us_32();
+uint64_t time_us_64();
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_PICO_MULTICORE_H
+#define SIM_PICO_MULTICORE_H
+
+// A szimulator egy magon fut
+inline void multicore_launch_core1(void (*entry)(void)) { (void)entry; }
+
+#endif
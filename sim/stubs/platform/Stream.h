@@ -0,0 +1,3 @@
+#ifndef SIM_PLATFORM_STREAM_H
+#define SIM_PLATFORM_STREAM_H
+#endif
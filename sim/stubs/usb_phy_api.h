@@ -0,0 +1,7 @@
+#ifndef SIM_USB_PHY_API_H
+#define SIM_USB_PHY_API_H
+
+class USBPhy;
+inline USBPhy *get_usb_phy() { return nullptr; }
+
+#endif
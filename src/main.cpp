@@ -4,13 +4,30 @@
 #include <pico/multicore.h>
 #include <vector>
 #include <Wire.h>
-#include <I2C_eeprom.h>
+#include <I2CBus.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <StaticSSD1306.h>
 #include <MCP3008Reader.h>
 #include <PicoGamepad.h>
+#include <AxisRoutes.h>
+#ifdef COMPOSITE_GAMEPAD
+#include <CompositeGamepad.h>
+#endif
+#include <LatencyProbe.h>
+#include <Scheduler.h>
+#include <MappingProfile.h>
+#include <EEPROMStorage.h>
+#include <MemoryStorage.h>
+#ifdef FLASH_STORAGE
+#include <FlashStorage.h>
+#endif
+#include <SampleStream.h>
+#include <MemoryReport.h>
+#ifdef BENCHMARK
+#include <Benchmark.h>
+#endif
 //#include <Oversample.h>
-#include <EMA.h>
 
 #define DEBUG
 
@@ -30,21 +47,121 @@ LED led(LED_BUILTIN, 1000); // Initialize LED on built-in pin with 100ms toggle
 //
 const int8_t MCP3008_CS_PIN = 17;              // Chip Select pin for MCP3008
 const uint8_t MCP3008_CHANNELS = 8;            // Number of channels to read
-const uint8_t MCP3008_VALUES_PER_CHANNEL = 21; // Number of values to store per channel
+const uint8_t MCP3008_VALUES_PER_CHANNEL = 21; // Maximum median filter window per channel
+const uint8_t MCP3008_MEDIAN_WINDOW = 5;       // Median window on active channels (wiper spikes)
+const uint32_t PREDICTION_POLL_LEAD_US = 500;  // a report atlagosan fel USB poll intervallumot var a hostra
+const uint16_t JITTER_TARGET_HID = 16;         // nyugalmi kimeneti szoras celja HID countban (EMA hangolas)
+#ifdef RATIOMETRIC_REFERENCE
+const int8_t REFERENCE_CHANNEL = CHANNEL_EMPTY_1; // oszto a potmeterek taprol, ~3/4 tap
+const uint16_t REFERENCE_NOMINAL = 0;             // 0: inditaskor merve
+const bool REFERENCE_DIFFERENTIAL = false;        // CH7 a potmeterek fold visszavezeteserol, IN-
+#endif
 //const uint16_t MCP3008_PROC_TICK_TIME = 10;    // Time interval for reading channels in milliseconds
 Adafruit_MCP3008 adcChip;
 MCP3008Reader adcMCP3008(&adcChip, MCP3008_CHANNELS, MCP3008_VALUES_PER_CHANNEL);
 
 // Initialize I2C for EEPROM
 arduino::MbedI2C Wire1(6, 7);
-// Init EEPROM
-I2C_eeprom eeprom(0x50, I2C_DEVICESIZE_24LC64, &Wire1); // I2C address for the EEPROM
+// EEPROM es kijelzo a kozos buszon, tranzakcio sorral
+const uint8_t EEPROM_ADDRESS = 0x50;                   // I2C address for the EEPROM
+const uint32_t EEPROM_MAX_CLOCK_HZ = I2C_FAST_MODE_HZ;  // 24LC64: 400 kHz (a 24FC64 birna 1 MHz-et)
+const uint32_t DISPLAY_MAX_CLOCK_HZ = I2C_FAST_MODE_HZ; // SSD1306: 2.5 us orajel ciklus
+const uint32_t I2C_BUDGET_US = 500;                    // egy I2C tranzakcio / task futas leghosszabb ideje
+I2CBus i2cBus(&Wire1);
+EEPROMStorage eepromStorage(&i2cBus, EEPROM_ADDRESS);
+
+// Limitek (0..3) es profilok hatterben beolvasott kepe; a betoltes ebbol olvas, nem a buszrol
+uint8_t eepromImage[PROFILE_STORE_END];
+MemoryStorage eepromImageStorage(eepromImage, sizeof(eepromImage));
+volatile I2CJobStatus eepromImageStatus = I2C_JOB_DONE;
+
+#ifdef FLASH_STORAGE
+// Limitek es profilok a QSPI flash utolso ket szektoraban (XIP olvasas), EEPROM helyett
+const uint32_t FLASH_STORAGE_OFFSET = 2 * 1024 * 1024 - 2 * FLASH_STORAGE_SECTOR; // Pico: 2 MB flash
+uint8_t flashShadow[PROFILE_STORE_END];
+FlashStorage flashStorage(FLASH_STORAGE_OFFSET, flashShadow, sizeof(flashShadow));
+#endif
 
 // Initialize OLED display
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire1, OLED_RESET);
+StaticSSD1306<SCREEN_WIDTH, SCREEN_HEIGHT> display(&Wire1, OLED_RESET, DISPLAY_MAX_CLOCK_HZ); // frame buffer statikusan, nem heap-en
+
+// Alapertelmezett profil a channelMinMaxValues_ tablabol
+MappingProfile makeDefaultProfile()
+{
+  MappingProfile profile = {};
+  strncpy(profile.name, "default", PROFILE_NAME_LENGTH - 1);
+  for (uint8_t ch = 0; ch < PROFILE_CHANNELS; ++ch)
+  {
+    ChannelProfile &cp = profile.channels[ch];
+    cp.minValue = channelMinMaxValues_[ch].minValue;
+    cp.maxValue = channelMinMaxValues_[ch].maxValue;
+    cp.flags = (channelMinMaxValues_[ch].isInverted ? PROFILE_FLAG_INVERTED : 0) |
+               (channelMinMaxValues_[ch].isActive ? PROFILE_FLAG_ACTIVE : 0);
+  }
+  return profile;
+}
+
+// Mapping profiles (EEPROM), switched with 'P<n>' over Serial
+ProfileManager profiles(makeDefaultProfile());
 
+#ifdef COMPOSITE_GAMEPAD
+// Composite device: pedals, throttle quadrant and hand wheel as separate controllers
+VirtualGamepad pedals({1, 0x04, 0, 3, 0, 2000});   // X: rudder, Y: bal fek, Z: jobb fek
+VirtualGamepad throttle({2, 0x04, 0, 2, 0, 5000}); // X: bal gaz, Y: jobb gaz
+VirtualGamepad handWheel({3, 0x04, 0, 1, 0, 2000}); // X: kormany
+VirtualGamepad *const gamepads[] = {&pedals, &throttle, &handWheel};
+CompositeGamepad joystick(gamepads, sizeof(gamepads) / sizeof(gamepads[0]));
+
+// AxisRouter cel: a route target mezoje az eszkoz, a slot a tengely index
+struct CompositeAxisSink
+{
+  template <uint8_t TARGET, uint8_t SLOT>
+  inline void write(int16_t value) { gamepads[TARGET]->setAxis(SLOT, value); }
+};
+#else
 // Initialize PicoGamepad
 PicoGamepad joystick;
+#endif
+
+// Binary sample stream over USB CDC, toggled with 'T' over Serial
+SampleStream sampleStream(&Serial);
+
+//
+// Task timing
+//
+#ifdef CIC_DECIMATION
+const uint32_t ACQUISITION_PERIOD_US = 250;  // ADC olvasas 4 kHz (32 ksps), CIC utan 1 kHz az EMA-ba
+const uint8_t CIC_STAGES = 3;
+const uint8_t CIC_RATE_LOG2 = 2;             // 4-szeres decimalas
+#else
+const uint32_t ACQUISITION_PERIOD_US = 500;  // ADC olvasas + EMA, 2 kHz
+#endif
+#ifdef COMPOSITE_GAMEPAD
+const uint32_t REPORT_PERIOD_US = 1000;      // eszkozonkent a sajat intervallum szerint kuld
+#else
+const uint32_t REPORT_PERIOD_US = 50000;     // HID report kuldes
+#endif
+const uint32_t CONSOLE_PERIOD_US = 20000;    // Serial parancsok feldolgozasa
+const uint32_t STREAM_PERIOD_US = 1000;      // stream sor kiirasa
+const uint32_t TUNING_PERIOD_US = 100000;    // zaj blokkok kiertekelese, EMA hangolas
+const uint32_t I2C_PERIOD_US = 1000;         // I2C sor: tranzakciok a budget erejeig
+const uint32_t PERIPHERAL_STEP_US = 5000;    // hatter inicializalas lepesei kozott
+const uint32_t PERIPHERAL_RETRY_US = 2000000; // hianyzo EEPROM / kijelzo ujraprobalasa
+const uint16_t LED_BLINK_MS = 1000;          // normal mukodes
+const uint16_t LED_FAULT_BLINK_MS = 100;     // hibajelzes
+
+Scheduler scheduler;
+int8_t acquisitionTask = -1;
+int8_t reportTask = -1;
+int8_t ledTask = -1;
+int8_t consoleTask = -1;
+int8_t streamTask = -1;
+int8_t peripheralTask = -1;
+int8_t tuningTask = -1;
+int8_t i2cTask = -1;
+
+// Boot idozites: az elso HID report ideje a bekapcsolastol
+uint32_t firstReportUs = 0;
 
 // Log to Serial
 void logToSerial(const String &message)
@@ -55,114 +172,486 @@ void logToSerial(const String &message)
   }
 }
 
-// uitn16_t ertek ira EEPROM-ba a megadott cimen
+// uitn16_t ertek ira EEPROM-ba a megadott cimen (sorba allitva, a kep is frissul)
 int updateUint16ToEEPROM(int address, uint16_t value)
 {
-  uint8_t lowByte = value & 0xFF;         // Az alsó bájt
-  uint8_t highByte = (value >> 8) & 0xFF; // A felső bájt
+  uint8_t bytes[2] = {static_cast<uint8_t>(value & 0xFF), static_cast<uint8_t>((value >> 8) & 0xFF)}; // also, felso bajt
+#ifdef FLASH_STORAGE
+  // Csak a RAM kep valtozik, a flashStorage.commit() irja ki
+  return flashStorage.write(address, bytes, sizeof(bytes)) ? 0 : -1;
+#else
+  eepromImageStorage.write(address, bytes, sizeof(bytes));
+  return eepromStorage.write(address, bytes, sizeof(bytes)) ? 0 : -1; // 0 ha a sorba kerult
+#endif
+}
+
+// uint16_t ertek kiolvasasa az EEPROM kepbol a megadott cimrol
+uint16_t readUint16FromEEPROM(int address)
+{
+  uint8_t bytes[2] = {0, 0};
+#ifdef FLASH_STORAGE
+  flashStorage.read(address, bytes, sizeof(bytes));
+#else
+  eepromImageStorage.read(address, bytes, sizeof(bytes));
+#endif
+  return (static_cast<uint16_t>(bytes[1]) << 8) | bytes[0]; // Egyesítjük a két bájtot egy uint16_t értékké
+}
+
+int ch4_limter_min; // Minimum limit for channel 4
+int ch4_limter_max; // Maximum limit for channel 4
+
+// Hatterben inditott periferiak allapota
+enum PeripheralStep : uint8_t
+{
+  PERIPHERAL_I2C,      // Wire1 + I2C sor
+  PERIPHERAL_EEPROM,   // EEPROM keresese, a limitek es profilok kepenek olvasasa a sorban
+  PERIPHERAL_EEPROM_LOAD, // kep kesz: limitek es profilok betoltese
+  PERIPHERAL_DISPLAY,  // SSD1306 keresese, init es torles a sorban
+  PERIPHERAL_DONE      // minden lepes lefutott; hianyzo eszkozok ujraprobalasa
+};
+PeripheralStep peripheralStep = PERIPHERAL_I2C;
+bool eepromPresent = false;
+bool displayPresent = false;
+bool eepromMissingLogged = false;  // a hiany uzenete csak egyszer
+bool displayMissingLogged = false;
+bool eepromSaveStarted = false;   // volt 'W' mentes
+bool eepromSaveQueued = false;    // az utolso mentes minden irasa a sorba kerult
+
+//
+// Tasks
+//
+void acquisitionTaskFn(void *)
+{
+  adcMCP3008.readChannelsWithEMA();
+
+  if (sampleStream.isEnabled())
+  {
+    StreamSample sample;
+    sample.timestampUs = micros();
+    for (uint8_t ch = 0; ch < STREAM_CHANNELS; ++ch)
+    {
+      sample.raw[ch] = adcMCP3008.getRawValue(ch);
+      sample.filtered[ch] = adcMCP3008.getEMAValues(ch);
+      sample.mapped[ch] = adcMCP3008.getMappedJoystickValue(ch);
+    }
+    sampleStream.push(sample);
+  }
+}
 
-  int statusLow = eeprom.updateByte(address, lowByte);
-  if (statusLow != 0)
+void reportTaskFn(void *)
+{
+  LATENCY_MARK(MARK_MAP_START);
+  // Profil valtas a frame hataran: nyugalmi pont, majd az aktualis snapshot pointere.
+  // Az acquisition (stream) is ezt a snapshotot hasznalja a kovetkezo frame-ig.
+  adcMCP3008.setMapping(profiles.acquire());
+#ifdef COMPOSITE_GAMEPAD
+  // Csatorna -> tengely kiosztas: COMPOSITE_AXIS_ROUTES, forditaskor kifejtve
+  CompositeAxisSink sink;
+  CompositeAxisRouter::apply(adcMCP3008, sink);
+  LATENCY_MARK(MARK_MAP_END);
+  bool sent = joystick.poll(micros()) > 0;
+  if (sent)
+  {
+    LATENCY_MARK(MARK_SEND_END);
+    LATENCY_COMMIT();
+  }
+#else
+  // Csatorna -> tengely kiosztas: HID_AXIS_ROUTES, forditaskor kifejtve
+  ReportAxisSink sink = {joystick.inputs()};
+  HidAxisRouter::apply(adcMCP3008, sink);
+  LATENCY_MARK(MARK_MAP_END);
+  bool sent = joystick.send_update();
+  LATENCY_MARK(MARK_SEND_END);
+  LATENCY_COMMIT();
+#endif
+  if (sent && firstReportUs == 0)
   {
-    return statusLow; // Hibakód visszaadása, ha az alsó bájt írása sikertelen
+    firstReportUs = micros();
   }
+}
 
-  int statusHigh = eeprom.updateByte(address + 1, highByte);
-  return statusHigh; // Visszatér a felső bájt írásának státuszával (0 ha sikeres)
+// Kijelzo tartalom: aktiv profil; a kuldes a busz taskban, darabokban
+void showProfile()
+{
+  if (!displayPresent)
+  {
+    return;
+  }
+  display.clearDisplay();
+  display.setTextColor(SSD1306_WHITE);
+  display.setCursor(0, 0);
+  display.print("Profile ");
+  display.print(profiles.currentIndex());
+  display.setCursor(0, 16);
+  display.print(profiles.profile(profiles.currentIndex()).name);
+  i2cBus.flushDisplay(SCREEN_ADDRESS, display.frameBuffer(), display.frameBufferSize());
 }
 
-// uint16_t ertek kiolvasasa az EEPROM-bol a megadott cimrol
-uint16_t readUint16FromEEPROM(int address)
+// EEPROM es kijelzo inditasa a hatterben, taskonkent egy lepes.
+// Hianyzo eszkoz eseten a joystick tovabb mukodik alapertelmezett profillal / kijelzo nelkul.
+void peripheralTaskFn(void *)
 {
-  uint8_t lowByte = eeprom.readByte(address);      // Az alsó bájt
-  uint8_t highByte = eeprom.readByte(address + 1); // A felső bájt
+  switch (peripheralStep)
+  {
+  case PERIPHERAL_I2C:
+#ifndef FLASH_STORAGE
+    i2cBus.addDevice(EEPROM_ADDRESS, EEPROM_MAX_CLOCK_HZ);
+#endif
+    i2cBus.addDevice(SCREEN_ADDRESS, DISPLAY_MAX_CLOCK_HZ);
+    i2cBus.setBudget(I2C_BUDGET_US);
+    i2cBus.begin(); // Join I2C bus as master
+    logToSerial("I2C clock: " + String(i2cBus.clock()) + " Hz");
+    peripheralStep = PERIPHERAL_EEPROM;
+    break;
+
+  case PERIPHERAL_EEPROM:
+#ifdef FLASH_STORAGE
+    // A profilok a flash-bol mar a setup()-ban betoltodtek, EEPROM-ot nem kell keresni
+    eepromPresent = true;
+    peripheralStep = PERIPHERAL_DISPLAY;
+#else
+    if (!eepromPresent && i2cBus.probe(EEPROM_ADDRESS) &&
+        i2cBus.readMemory(EEPROM_ADDRESS, 0, eepromImage, sizeof(eepromImage), &eepromImageStatus))
+    {
+      // A kep a busz taskban olvasodik, a kijelzo keresese addig is mehet
+      eepromPresent = true;
+      logToSerial("EEPROM connected.");
+      peripheralStep = PERIPHERAL_EEPROM_LOAD;
+      break;
+    }
+    else if (!eepromPresent && !eepromMissingLogged)
+    {
+      // Csak az elso probalkozasnal; az ujraprobalas 2 s-onkent nem teriti el a logot
+      eepromMissingLogged = true;
+      logToSerial("EEPROM not connected, using default profile.");
+    }
+    peripheralStep = PERIPHERAL_DISPLAY;
+#endif
+    break;
+
+  case PERIPHERAL_EEPROM_LOAD:
+    if (eepromImageStatus == I2C_JOB_PENDING)
+    {
+      break;
+    }
+    if (eepromImageStatus == I2C_JOB_DONE)
+    {
+      // Read limits from EEPROM
+      ch4_limter_min = readUint16FromEEPROM(0);
+      ch4_limter_max = readUint16FromEEPROM(2);
 
-  return (static_cast<uint16_t>(highByte) << 8) | lowByte; // Egyesítjük a két bájtot egy uint16_t értékké
+      // Mapping profiles; a tablak itt, a frame-en kivul keszulnek el
+      profiles.load(&eepromImageStorage);
+      showProfile();
+    }
+    else
+    {
+      eepromPresent = false;
+      logToSerial("EEPROM read failed, using default profile.");
+    }
+    peripheralStep = PERIPHERAL_DISPLAY;
+    break;
+
+  case PERIPHERAL_DISPLAY:
+    if (!displayPresent && i2cBus.probe(SCREEN_ADDRESS))
+    {
+      // Init parancsok, majd az ures (vagy profil) kep; mindketto a sorban, darabolva
+      uint8_t length;
+      const uint8_t *commands = display.initCommands(length);
+      if (i2cBus.sendCommands(SCREEN_ADDRESS, commands, length))
+      {
+        displayPresent = true;
+        logToSerial("SSD1306 connected.");
+        showProfile();
+      }
+    }
+    else if (!displayPresent && !displayMissingLogged)
+    {
+      displayMissingLogged = true;
+      logToSerial("SSD1306 not connected, running without display.");
+    }
+    peripheralStep = PERIPHERAL_DONE;
+    break;
+
+  case PERIPHERAL_DONE:
+    static bool bootTimeLogged = false;
+    if (firstReportUs && !bootTimeLogged)
+    {
+      bootTimeLogged = true;
+      logToSerial("First HID report after " + String(firstReportUs) + " us");
+    }
+    if (eepromPresent && displayPresent)
+    {
+      scheduler.setEnabled(peripheralTask, false);
+      break;
+    }
+    // Hianyzo eszkoz: ritkabban ujraprobaljuk
+    scheduler.setPeriod(peripheralTask, PERIPHERAL_RETRY_US);
+    peripheralStep = PERIPHERAL_EEPROM;
+    break;
+  }
 }
 
-int ch4_limter_min; // Minimum limit for channel 4
-int ch4_limter_max; // Maximum limit for channel 4
+void streamTaskFn(void *)
+{
+  sampleStream.flush();
+}
+
+void i2cTaskFn(void *)
+{
+  i2cBus.service();
+}
+
+void tuningTaskFn(void *)
+{
+  adcMCP3008.updateFilterTuning();
+}
+
+// Zaj statisztika csatornankent: "#NOISE,ch,sd_mcount,rest_blocks,moving_blocks,ema_shift"
+void printNoiseReport(Print &out)
+{
+  out.println("#NOISE,channel,sd_mcount,rest_blocks,moving_blocks,ema_shift");
+  for (uint8_t ch = 0; ch < MCP3008_CHANNELS; ++ch)
+  {
+    const NoiseEstimator &noise = adcMCP3008.noise(ch);
+    out.print("#NOISE,");
+    out.print(ch);
+    out.print(',');
+    out.print(static_cast<uint32_t>(sqrtf(noise.varianceQ8() / 256.0f) * 1000.0f));
+    out.print(',');
+    out.print(noise.restBlocks());
+    out.print(',');
+    out.print(noise.movingBlocks());
+    out.print(',');
+    out.println(adcMCP3008.getEmaShift(ch));
+  }
+  if (adcMCP3008.getReferenceChannel() >= 0)
+  {
+    out.println("#REF,channel,nominal_q8,gain_q16,faults");
+    out.print("#REF,");
+    out.print(adcMCP3008.getReferenceChannel());
+    out.print(',');
+    out.print(adcMCP3008.getReferenceNominalQ8());
+    out.print(',');
+    out.print(adcMCP3008.getReferenceGainQ16());
+    out.print(',');
+    out.println(adcMCP3008.getReferenceFaults());
+  }
+}
+
+void ledTaskFn(void *)
+{
+  led.toggle();
+}
+
+// 'S' a Serial-on: task statisztika, 'M': stack/heap hasznalat, 'T': binaris stream be/ki, 'P<n>': profil valtas, 'A': prediktor be/ki, 'N': zaj es EMA hangolas, 'F': frame igazitas (ki / igazitott / + valtakozo sorrend), 'W': profil mentes, 'I': I2C statisztika es az utolso mentes eredmenye, 'L': latency riport, 'B': benchmark, 'R': statisztikak torlese
+void consoleTaskFn(void *)
+{
+  if (!Serial || !Serial.available())
+  {
+    return;
+  }
+  int cmd = Serial.read();
+  if (cmd == 'S')
+  {
+    scheduler.printStats(Serial);
+  }
+  else if (cmd == 'M')
+  {
+    printMemoryReport(Serial);
+  }
+#ifdef LATENCY_PROBE
+  else if (cmd == 'L')
+  {
+    LatencyProbe::printReport(Serial);
+  }
+#endif
+#ifdef BENCHMARK
+  else if (cmd == 'B')
+  {
+    printBenchmarkResult(Serial, "time_to_first_report", firstReportUs, "us");
+    runBenchmarks(Serial, &adcChip, &adcMCP3008);
+  }
+#endif
+  else if (cmd == 'T')
+  {
+    sampleStream.setEnabled(!sampleStream.isEnabled());
+  }
+  else if (cmd == 'P')
+  {
+    int index = Serial.read() - '0';
+    if (index >= 0 && index < PROFILE_COUNT)
+    {
+      if (profiles.select(index))
+      {
+        logToSerial("Profile " + String(index) + ": " + String(profiles.profile(index).name));
+        showProfile();
+      }
+      else
+      {
+        // Minden slot visszatartva, a kovetkezo report frame utan ujra probalhato
+        logToSerial("Profile " + String(index) + " busy, retry");
+      }
+    }
+  }
+  else if (cmd == 'W')
+  {
+    // Aktiv profil mentese; a lapokat a busz task irja, a vezerlo hurok nem var
+    uint8_t index = profiles.currentIndex();
+#ifdef FLASH_STORAGE
+    // Egy szektor iras az egesz mentesre; kozben ~50 ms-ig nincs report
+    bool saved = profiles.save(&flashStorage, index) && flashStorage.commit();
+    logToSerial("Profile " + String(index) + (saved ? " saved to flash" : " save failed"));
+#else
+    // A kep is frissul: a readUint16FromEEPROM() es egy kesobbi betoltes abbol olvas
+    profiles.save(&eepromImageStorage, index);
+    eepromStorage.clearWriteStatus();
+    eepromSaveStarted = true;
+    eepromSaveQueued = profiles.save(&eepromStorage, index);
+    logToSerial("Profile " + String(index) + (eepromSaveQueued ? " save queued ('I': result)" : " save failed"));
+#endif
+  }
+  else if (cmd == 'I')
+  {
+    i2cBus.printStats(Serial);
+#ifndef FLASH_STORAGE
+    if (eepromSaveStarted)
+    {
+      // Az utolso 'W' mentes osszes irasa
+      I2CJobStatus saveStatus = eepromSaveQueued ? eepromStorage.writeStatus() : I2C_JOB_FAILED;
+      logToSerial(String("EEPROM save: ") + (saveStatus == I2C_JOB_PENDING ? "pending" : saveStatus == I2C_JOB_DONE ? "done" : "failed"));
+    }
+#endif
+  }
+  else if (cmd == 'N')
+  {
+    printNoiseReport(Serial);
+  }
+  else if (cmd == 'F')
+  {
+    // ki -> igazitott -> igazitott, valtakozo sorrenddel -> ki
+    bool aligned = adcMCP3008.isAlignedFrames();
+    bool alternate = adcMCP3008.isAlternateOrder();
+    adcMCP3008.setAlignedFrames(!aligned || !alternate, aligned && !alternate);
+    logToSerial(String("Aligned frames ") + (!adcMCP3008.isAlignedFrames() ? "off" : adcMCP3008.isAlternateOrder() ? "on, alternating order" : "on"));
+  }
+  else if (cmd == 'A')
+  {
+    // Prediktor az aktiv csatornakon, az EMA helyett
+    bool enable = !adcMCP3008.isPredictorEnabled(CHANNEL_RUDDER);
+    for (uint8_t ch = 0; ch < MCP3008_CHANNELS; ++ch)
+    {
+      if (channelMinMaxValues_[ch].isActive)
+      {
+        adcMCP3008.setPredictorEnabled(ch, enable);
+      }
+    }
+    logToSerial(String("Prediction ") + (enable ? "on" : "off"));
+  }
+  else if (cmd == 'R')
+  {
+    scheduler.resetStats();
+    i2cBus.resetStats();
+#ifdef LATENCY_PROBE
+    LatencyProbe::reset();
+#endif
+  }
+}
+
+// Hiba eseten csak a gyors LED villogas marad, az adatgyujtes leall
+void enterFault(const String &message)
+{
+  logToSerial(message);
+  scheduler.setEnabled(acquisitionTask, false);
+  scheduler.setEnabled(reportTask, false);
+  scheduler.setPeriod(ledTask, LED_FAULT_BLINK_MS * 1000UL);
+}
 
 //
 // Setup function
-// Initializes the MCP3008 and launches the core1 task
+// Brings up the ADC and the HID report path first, so the controller is
+// usable right after power-on. EEPROM and display come up later in the
+// peripheral task and may be missing.
 //
 void setup()
 {
+  // Stack high-water mark meresehez
+  paintStack();
+
   // LED off
   led.off();
 
-  // Init Serial and wait for connection
+  // Init Serial, nem varunk a kapcsolatra; elobb, mint barmelyik hiba ag, hogy az uzenet kimenjen
   if (!Serial)
     Serial.begin(115200);
-  logToSerial("Program started");
-
-  // Init I2C for EEPROM
-  logToSerial("I2C_EEPROM_VERSION: " + String(I2C_EEPROM_VERSION));
 
-  Wire1.begin();  // Join I2C bus as master
-  eeprom.begin(); // Initialize EEPROM
-  if (!eeprom.isConnected())
+  // Tasks, fontossagi sorrendben (0 = legfontosabb)
+  acquisitionTask = scheduler.addTask("acquisition", acquisitionTaskFn, nullptr, ACQUISITION_PERIOD_US, 0);
+  reportTask = scheduler.addTask("report", reportTaskFn, nullptr, REPORT_PERIOD_US, 1);
+  streamTask = scheduler.addTask("stream", streamTaskFn, nullptr, STREAM_PERIOD_US, 2);
+  consoleTask = scheduler.addTask("console", consoleTaskFn, nullptr, CONSOLE_PERIOD_US, 3);
+  ledTask = scheduler.addTask("led", ledTaskFn, nullptr, LED_BLINK_MS * 1000UL, 4);
+  tuningTask = scheduler.addTask("tuning", tuningTaskFn, nullptr, TUNING_PERIOD_US, 5);
+  i2cTask = scheduler.addTask("i2c", i2cTaskFn, nullptr, I2C_PERIOD_US, 6);
+  peripheralTask = scheduler.addTask("peripheral", peripheralTaskFn, nullptr, PERIPHERAL_STEP_US, 7);
+  const int8_t taskIds[] = {acquisitionTask, reportTask, streamTask, consoleTask,
+                            ledTask, tuningTask, i2cTask, peripheralTask};
+  for (int8_t id : taskIds)
   {
-    logToSerial("EEPROM not connected!");
-    while (true)
+    if (id < 0)
     {
-      led.refresh(100);
+      // Betelt a task tabla (SCHEDULER_MAX_TASKS): a hianyzo task csendben nem futna
+      enterFault("Scheduler task table full");
+      return;
     }
   }
-  else
-  {
-    logToSerial("EEPROM connected.");
-  }
 
-  // Init OLED display
-  if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS))
+  // Init MCP3008
+  for (uint8_t ch = 0; ch < MCP3008_CHANNELS; ++ch)
   {
-    logToSerial("SSD1306 allocation failed");
-    while (true)
+    if (channelMinMaxValues_[ch].isActive)
     {
-      led.refresh(100);
+      adcMCP3008.setMedianWindow(ch, MCP3008_MEDIAN_WINDOW);
+      adcMCP3008.setAutoTune(ch, true);
     }
   }
-  else
+  adcMCP3008.setJitterTarget(JITTER_TARGET_HID);
+#ifdef FLASH_STORAGE
+  // XIP olvasas busz nelkul: az elso report mar a mentett profillal megy
+  if (flashStorage.begin())
   {
-    logToSerial("SSD1306 connected.");
+    ch4_limter_min = readUint16FromEEPROM(0);
+    ch4_limter_max = readUint16FromEEPROM(2);
+    profiles.load(&flashStorage);
   }
-  display.clearDisplay();
-  display.display();
-
-  // Read limits from EEPROM
-  ch4_limter_min = readUint16FromEEPROM(0);
-  ch4_limter_max = readUint16FromEEPROM(2);
-
-  // Init MCP3008
+#endif
+#ifdef RATIOMETRIC_REFERENCE
+  adcMCP3008.setDifferential(REFERENCE_CHANNEL, REFERENCE_DIFFERENTIAL);
+  adcMCP3008.setReferenceChannel(REFERENCE_CHANNEL, REFERENCE_NOMINAL);
+#endif
+#ifdef CIC_DECIMATION
+  adcMCP3008.setDecimation(CIC_STAGES, CIC_RATE_LOG2, true);
+  adcMCP3008.setPredictionTiming(ACQUISITION_PERIOD_US << CIC_RATE_LOG2, PREDICTION_POLL_LEAD_US);
+#else
+  adcMCP3008.setPredictionTiming(ACQUISITION_PERIOD_US, PREDICTION_POLL_LEAD_US);
+#endif
 
   if (!adcChip.begin(MCP3008_CS_PIN))
   {
-    // Hibajelzés: gyors villogás vagy végtelen ciklus
-    while (1)
-    {
-      led.toggle();
-      delay(100);
-    }
+    // Hibajelzés: gyors villogás
+    enterFault("MCP3008 init failed");
+    return;
   }
+
+  logToSerial("Program started");
+#ifdef FLASH_STORAGE
+  logToSerial("Flash storage: sector " + String(flashStorage.activeSector()) + ", sequence " +
+              String(flashStorage.sequence()));
+#endif
 }
 
 void loop()
 {
-  static uint32_t lastTime = 0;
-  
-  adcMCP3008.readChannelsWithEMA();
-
-  if (millis() - lastTime > 50)
-  {
-    lastTime = millis();
-    joystick.SetX(adcMCP3008.getMappedJoystickValue(CHANNEL_HAND_WHEEL));
-    joystick.SetY(adcMCP3008.getMappedJoystickValue(CHANNEL_RUDDER));
-    joystick.SetRx(adcMCP3008.getMappedJoystickValue(CHANNEL_THROTTLE_LEFT));
-    joystick.SetRy(adcMCP3008.getMappedJoystickValue(CHANNEL_THROTTLE_RIGHT));
-    joystick.SetSlider(adcMCP3008.getMappedJoystickValue(CHANNEL_BRAKE_LEFT));
-    joystick.SetDial(adcMCP3008.getMappedJoystickValue(CHANNEL_BRAKE_RIGHT));
-    joystick.send_update();
-  }
-}
\ No newline at end of file
+  // Kovetkezo task futtatasa, vagy alvas (WFE) a kovetkezo kiadasig
+  scheduler.run();
+}
@@ -0,0 +1,276 @@
+//
+// Frame alignment: residual inter-channel skew after alignSample() on a
+// synthetic ramp and sine (8 channels see the same signal), then through
+// MCP3008Reader on the simulated MCP3008, where each read takes 30 us and
+// the last channel of a frame is 210 us late without alignment.
+//   pio test -e native -f test_alignment
+//
+#include <unity.h>
+#include <MCP3008Reader.h>
+#include <SimHardware.h>
+#include <math.h>
+
+static const uint16_t ALIGN_FRAMES = 2000;
+static const uint16_t ALIGN_SETTLE = 4;            // az elso frame-eknek nincs elozo mintaja
+static const uint32_t ALIGN_FRAME_US = 500;        // acquisition periodus
+static const uint32_t ALIGN_READ_US = 30;          // csatornankent (sim ADC_READ_US)
+static const float ALIGN_RAMP_SLOPE = 1.0f / 1000; // count / us (1 count / ms)
+static const float ALIGN_SINE_HZ = 20.0f;
+static const float ALIGN_SINE_AMPLITUDE = 400.0f;
+
+enum AlignSignal : uint8_t
+{
+    ALIGN_RAMP,
+    ALIGN_SINE
+};
+
+static float alignSignal(AlignSignal signal, uint32_t us)
+{
+    if (signal == ALIGN_RAMP)
+    {
+        return 100.0f + ALIGN_RAMP_SLOPE * us;
+    }
+    return 512.0f + ALIGN_SINE_AMPLITUDE * sinf(2.0f * static_cast<float>(M_PI) * ALIGN_SINE_HZ * us / 1e6f);
+}
+
+struct AlignResult
+{
+    float spreadMax;  // egy frame-en beluli legnagyobb elteres a csatornak kozott (count)
+    float biasMax;    // a csatornankenti atlagos hibak legnagyobb kulonbsege (count)
+    float rms;        // hiba a frame idopontjahoz kepest (count)
+};
+
+// Az olvasasi sorrend es az igazitas szintetikus jelen; az idealis kimenet minden csatornan
+// a jel a frame elejen
+static AlignResult evaluateAlignment(AlignSignal signal, bool aligned, bool alternate)
+{
+    uint32_t prevUs[CHANNEL_COUNT] = {0};
+    uint32_t prevQ16[CHANNEL_COUNT] = {0};
+    float errorSum[CHANNEL_COUNT] = {0};
+    float squareSum = 0.0f;
+    AlignResult result = {0.0f, 0.0f, 0.0f};
+    bool reverse = false;
+
+    for (uint16_t frame = 0; frame < ALIGN_FRAMES; ++frame)
+    {
+        uint32_t frameUs = frame * ALIGN_FRAME_US;
+        reverse = alternate && !reverse;
+        float truth = alignSignal(signal, frameUs);
+        float lowest = 1e9f;
+        float highest = -1e9f;
+        for (uint8_t i = 0; i < CHANNEL_COUNT; ++i)
+        {
+            uint8_t ch = reverse ? CHANNEL_COUNT - 1 - i : i;
+            uint32_t sampleUs = frameUs + i * ALIGN_READ_US;
+            uint32_t q16 = static_cast<uint32_t>(alignSignal(signal, sampleUs) * 65536.0f + 0.5f);
+            uint32_t output = q16;
+            if (aligned)
+            {
+                output = MCP3008Reader::alignSample(q16, prevQ16[ch], sampleUs, prevUs[ch], frameUs);
+            }
+            prevQ16[ch] = q16;
+            prevUs[ch] = sampleUs;
+            if (frame < ALIGN_SETTLE)
+            {
+                continue;
+            }
+            float error = output / 65536.0f - truth;
+            errorSum[ch] += error;
+            squareSum += error * error;
+            lowest = error < lowest ? error : lowest;
+            highest = error > highest ? error : highest;
+        }
+        if (frame >= ALIGN_SETTLE && highest - lowest > result.spreadMax)
+        {
+            result.spreadMax = highest - lowest;
+        }
+    }
+
+    const float frames = ALIGN_FRAMES - ALIGN_SETTLE;
+    float lowest = 1e9f;
+    float highest = -1e9f;
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        float mean = errorSum[ch] / frames;
+        lowest = mean < lowest ? mean : lowest;
+        highest = mean > highest ? mean : highest;
+    }
+    result.biasMax = highest - lowest;
+    result.rms = sqrtf(squareSum / (frames * CHANNEL_COUNT));
+    return result;
+}
+
+// Rampa hibaja idoben (us): count / meredekseg
+static float rampSkewUs(float counts)
+{
+    return counts / ALIGN_RAMP_SLOPE;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_raw_frame_has_read_skew()
+{
+    // Igazitas nelkul az utolso csatorna 7 olvasasnyit keson mintavetelez
+    AlignResult raw = evaluateAlignment(ALIGN_RAMP, false, false);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 7.0f * ALIGN_READ_US, rampSkewUs(raw.spreadMax));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 7.0f * ALIGN_READ_US, rampSkewUs(raw.biasMax));
+
+    // A valtakozo sorrend csak a biast veszi ki, a frame-en beluli elteres marad
+    AlignResult alternating = evaluateAlignment(ALIGN_RAMP, false, true);
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0f, rampSkewUs(alternating.biasMax));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 7.0f * ALIGN_READ_US, rampSkewUs(alternating.spreadMax));
+}
+
+void test_aligned_ramp_skew()
+{
+    // Rampan a linearis interpolacio pontos: csak a Q16 kerekites marad
+    AlignResult aligned = evaluateAlignment(ALIGN_RAMP, true, false);
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0f, rampSkewUs(aligned.spreadMax));
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0f, rampSkewUs(aligned.biasMax));
+
+    AlignResult alternating = evaluateAlignment(ALIGN_RAMP, true, true);
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0f, rampSkewUs(alternating.spreadMax));
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0f, rampSkewUs(alternating.biasMax));
+}
+
+void test_aligned_sine_error()
+{
+    // 20 Hz, 400 count: igazitas nelkul ~8 count elteres a frame-en belul,
+    // igazitva csak az interpolacio gorbuleti hibaja marad
+    AlignResult raw = evaluateAlignment(ALIGN_SINE, false, false);
+    AlignResult aligned = evaluateAlignment(ALIGN_SINE, true, false);
+    TEST_ASSERT_GREATER_THAN_FLOAT(8.0f, raw.spreadMax);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.2f, aligned.spreadMax);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.15f, aligned.rms);
+}
+
+// Az igazi reader a szimulalt ADC-n: median es EMA nelkul a szurt ertek az igazitott minta.
+// Csatornankenti atlagos hiba idoben a haromszog jel egyenes szakaszain.
+static void measureReaderSkew(bool aligned, bool alternate, float *skewUs)
+{
+    static Adafruit_MCP3008 adc;
+    static MCP3008Reader reader(&adc, CHANNEL_COUNT, 21);
+    const double periodS = 0.05;
+    const double amplitude = 400.0;
+    const double slopePerUs = 4.0 * amplitude / (periodS * 1e6);
+
+    sim::Waveform wave;
+    wave.type = sim::WAVE_TRIANGLE;
+    wave.periodS = periodS;
+    wave.amplitude = amplitude;
+    wave.offset = 512.0;
+    wave.noise = 1.0; // dither: a kvantalasi hiba atlagban kiesik
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        sim::setWaveform(ch, wave);
+        reader.setMedianWindow(ch, 1);
+        reader.setEmaShift(ch, 0);
+    }
+    reader.setAlignedFrames(false, false);
+    reader.readChannelsWithEMA();
+    reader.setAlignedFrames(aligned, alternate);
+
+    double errorSum[CHANNEL_COUNT] = {0};
+    uint32_t counted = 0;
+    for (uint16_t frame = 0; frame < ALIGN_FRAMES; ++frame)
+    {
+        sim::advance(ALIGN_FRAME_US - (sim::now() % ALIGN_FRAME_US));
+        reader.readChannelsWithEMA();
+        double frameS = reader.getFrameUs() / 1e6;
+        double phase = fmod(frameS / periodS, 1.0);
+        // A csucsok kozeleben (+-1 ms) a linearis modell nem ervenyes
+        double edge = 1e-3 / periodS;
+        if (fabs(phase - 0.5) < edge || phase < edge || phase > 1.0 - edge)
+        {
+            continue;
+        }
+        double truth = 512.0 + amplitude * (phase < 0.5 ? 4.0 * phase - 1.0 : 3.0 - 4.0 * phase);
+        double slope = phase < 0.5 ? slopePerUs : -slopePerUs;
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+        {
+            errorSum[ch] += (reader.getFilteredQ16(ch) / 65536.0 - truth) / slope;
+        }
+        counted++;
+    }
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        skewUs[ch] = errorSum[ch] / counted;
+    }
+}
+
+void test_reader_raw_skew()
+{
+    float skewUs[CHANNEL_COUNT];
+    measureReaderSkew(false, false, skewUs);
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(3.0f, ch * ALIGN_READ_US, skewUs[ch]);
+    }
+}
+
+void test_reader_aligned_skew()
+{
+    float skewUs[CHANNEL_COUNT];
+    measureReaderSkew(true, false, skewUs);
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(3.0f, 0.0f, skewUs[ch]);
+    }
+
+    measureReaderSkew(true, true, skewUs);
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(3.0f, 0.0f, skewUs[ch]);
+    }
+}
+
+// Aranymetrikus korrekcioval: az igazitas bekapcsolasa utani elso frame a korrigalt elozo
+// mintahoz interpolal, nem a nyershez
+void test_enable_after_ratiometric_correction()
+{
+    static Adafruit_MCP3008 adc;
+    static MCP3008Reader reader(&adc, CHANNEL_COUNT, 21);
+    sim::Waveform reference;
+    reference.type = sim::WAVE_CONST;
+    reference.offset = 400.0;
+    sim::Waveform axis = reference;
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        sim::setWaveform(ch, ch == 0 ? reference : axis);
+        reader.setMedianWindow(ch, 1);
+        reader.setEmaShift(ch, 0);
+    }
+    // A referencia 400 az 500 nevleges helyett: 1.25-os korrekcio
+    reader.setReferenceChannel(0, 500);
+    reader.setAlignedFrames(false, false);
+    sim::advance(ALIGN_FRAME_US);
+    reader.readChannelsWithEMA();
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 500.0f, reader.getFilteredQ16(1) / 65536.0f);
+
+    reader.setAlignedFrames(true, false);
+    sim::advance(ALIGN_FRAME_US);
+    reader.readChannelsWithEMA();
+    for (uint8_t ch = 1; ch < CHANNEL_COUNT; ++ch)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, 500.0f, reader.getFilteredQ16(ch) / 65536.0f);
+    }
+    reader.setReferenceChannel(-1, 0);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_raw_frame_has_read_skew);
+    RUN_TEST(test_aligned_ramp_skew);
+    RUN_TEST(test_aligned_sine_error);
+    RUN_TEST(test_reader_raw_skew);
+    RUN_TEST(test_reader_aligned_skew);
+    RUN_TEST(test_enable_after_ratiometric_correction);
+    return UNITY_END();
+}
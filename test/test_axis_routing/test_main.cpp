@@ -0,0 +1,187 @@
+//
+// AxisRouter against the old hand-wired SetX/SetY/... report code and the
+// composite setAxis() lines: both read the same frames of the simulated
+// MCP3008 on the sim clock, which stands still between the two reads, so
+// the predicted values agree too. Reports must match byte for byte, with
+// and without a profile table and with the predictors on and off.
+//   pio test -e native -f test_axis_routing
+//
+#include <unity.h>
+#include <AxisRoutes.h>
+#include <SimHardware.h>
+
+static const uint16_t ROUTING_FRAMES = 256;
+static const uint32_t FRAME_PERIOD_US = 500;
+static const uint32_t REPORT_DELAY_US = 180; // frame vege es a report kozott (a prediktor elore lat)
+static const uint8_t VIRTUAL_AXES_CHECKED = 3; // legfeljebb ennyi tengely eszkozonkent a tablakban
+
+static Adafruit_MCP3008 adc;
+static MCP3008Reader reader(&adc, CHANNEL_COUNT, 21);
+
+// A regi reportTaskFn: egy hivas tengelyenkent, futasideju csatorna ellenorzessel
+static void handWiredReport(uint8_t *inputs)
+{
+    static const struct
+    {
+        uint8_t channel;
+        uint8_t offset;
+    } wiring[] = {
+        {CHANNEL_HAND_WHEEL, X_AXIS_LSB},     // SetX
+        {CHANNEL_RUDDER, Y_AXIS_LSB},         // SetY
+        {CHANNEL_THROTTLE_LEFT, Rx_AXIS_LSB}, // SetRx
+        {CHANNEL_THROTTLE_RIGHT, Ry_AXIS_LSB}, // SetRy
+        {CHANNEL_BRAKE_LEFT, SLIDER_AXIS_LSB}, // SetSlider
+        {CHANNEL_BRAKE_RIGHT, DIAL_AXIS_LSB}, // SetDial
+    };
+    for (const auto &axis : wiring)
+    {
+        uint16_t value = reader.getMappedJoystickValue(axis.channel);
+        inputs[axis.offset] = LSB(value);
+        inputs[axis.offset + 1] = MSB(value);
+    }
+}
+
+// Composite tengelyek egy tombbe, eszkoz x tengely
+struct ArrayAxisSink
+{
+    int16_t axes[3][VIRTUAL_AXES_CHECKED];
+
+    template <uint8_t TARGET, uint8_t SLOT>
+    inline void write(int16_t value) { axes[TARGET][SLOT] = value; }
+};
+
+// Mozgo, zajos, tuskes jelek minden tengelyen; a frame-ek kozott a prediktor is dolgozik
+static void setSignals()
+{
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        sim::Waveform wave;
+        wave.type = (ch & 1) ? sim::WAVE_TRIANGLE : sim::WAVE_SINE;
+        wave.periodS = 0.05 + 0.02 * ch;
+        wave.amplitude = 300.0;
+        wave.offset = 500.0;
+        wave.noise = 2.0;
+        wave.spikeRate = 0.01;
+        sim::setWaveform(ch, wave);
+    }
+}
+
+// Profil: szuk tartomany, holtsav es expo, egy inaktiv es egy invertalt csatorna
+static void buildProfileTable(MappingTable &table)
+{
+    MappingProfile profile = {};
+    for (uint8_t ch = 0; ch < PROFILE_CHANNELS; ++ch)
+    {
+        ChannelProfile &channel = profile.channels[ch];
+        channel.minValue = 250 + 10 * ch;
+        channel.maxValue = 700 + 5 * ch;
+        channel.flags = PROFILE_FLAG_ACTIVE;
+        channel.deadzone = 20;
+        channel.expo = 40 - 15 * ch;
+    }
+    profile.channels[CHANNEL_THROTTLE_LEFT].flags |= PROFILE_FLAG_INVERTED;
+    profile.channels[CHANNEL_BRAKE_RIGHT].flags = 0;
+    ProfileManager::buildTable(profile, table);
+}
+
+static void checkFrames(bool predicted)
+{
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        reader.setPredictorEnabled(ch, predicted);
+    }
+
+    uint8_t expected[DIAL_AXIS_MSB + 1];
+    uint8_t routed[DIAL_AXIS_MSB + 1];
+    for (uint16_t frame = 0; frame < ROUTING_FRAMES; ++frame)
+    {
+        reader.readChannelsWithEMA();
+        sim::advance(REPORT_DELAY_US);
+
+        memset(expected, 0, sizeof(expected));
+        memset(routed, 0, sizeof(routed));
+        handWiredReport(expected);
+        ReportAxisSink sink = {routed};
+        HidAxisRouter::apply(reader, sink);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, routed, sizeof(routed));
+
+        // Composite: a regi pedals/throttle/handWheel.setAxis() sorok
+        ArrayAxisSink composite = {};
+        CompositeAxisRouter::apply(reader, composite);
+        TEST_ASSERT_EQUAL_INT16(reader.getMappedJoystickValue(CHANNEL_RUDDER), composite.axes[0][0]);
+        TEST_ASSERT_EQUAL_INT16(reader.getMappedJoystickValue(CHANNEL_BRAKE_LEFT), composite.axes[0][1]);
+        TEST_ASSERT_EQUAL_INT16(reader.getMappedJoystickValue(CHANNEL_BRAKE_RIGHT), composite.axes[0][2]);
+        TEST_ASSERT_EQUAL_INT16(reader.getMappedJoystickValue(CHANNEL_THROTTLE_LEFT), composite.axes[1][0]);
+        TEST_ASSERT_EQUAL_INT16(reader.getMappedJoystickValue(CHANNEL_THROTTLE_RIGHT), composite.axes[1][1]);
+        TEST_ASSERT_EQUAL_INT16(reader.getMappedJoystickValue(CHANNEL_HAND_WHEEL), composite.axes[2][0]);
+
+        sim::advance(FRAME_PERIOD_US - REPORT_DELAY_US);
+    }
+}
+
+void setUp()
+{
+    sim::setSeed(0x5EED);
+    setSignals();
+    reader.setMapping(nullptr);
+    reader.setPredictionTiming(FRAME_PERIOD_US, 500);
+}
+
+void tearDown()
+{
+}
+
+void test_linear_mapping_ema()
+{
+    checkFrames(false);
+}
+
+void test_linear_mapping_predicted()
+{
+    checkFrames(true);
+}
+
+void test_profile_table_ema()
+{
+    static MappingTable table;
+    buildProfileTable(table);
+    reader.setMapping(&table);
+    checkFrames(false);
+}
+
+void test_profile_table_predicted()
+{
+    static MappingTable table;
+    buildProfileTable(table);
+    reader.setMapping(&table);
+    checkFrames(true);
+}
+
+// A tesztek nem trivialisak: a report tengelyek mozognak, nem csupa 0 vagy telitett ertek
+void test_reports_are_not_constant()
+{
+    uint8_t first[DIAL_AXIS_MSB + 1] = {0};
+    uint8_t later[DIAL_AXIS_MSB + 1] = {0};
+    reader.readChannelsWithEMA();
+    ReportAxisSink firstSink = {first};
+    HidAxisRouter::apply(reader, firstSink);
+    for (uint16_t frame = 0; frame < 40; ++frame)
+    {
+        sim::advance(FRAME_PERIOD_US);
+        reader.readChannelsWithEMA();
+    }
+    ReportAxisSink laterSink = {later};
+    HidAxisRouter::apply(reader, laterSink);
+    TEST_ASSERT_TRUE(memcmp(first + X_AXIS_LSB, later + X_AXIS_LSB, DIAL_AXIS_MSB + 1 - X_AXIS_LSB) != 0);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_linear_mapping_ema);
+    RUN_TEST(test_linear_mapping_predicted);
+    RUN_TEST(test_profile_table_ema);
+    RUN_TEST(test_profile_table_predicted);
+    RUN_TEST(test_reports_are_not_constant);
+    return UNITY_END();
+}
@@ -0,0 +1,182 @@
+//
+// CicDecimator frequency response with the pico_cic parameters (3 stages,
+// decimation by 4): DC exact, passband gain with and without the droop
+// compensator, rejection of the tones that alias into the passband, and
+// noise, each against Oversample-style summing (boxcar).
+//   pio test -e native -f test_cic
+//
+#include <unity.h>
+#include <CicDecimator.h>
+#include <math.h>
+
+static const uint8_t CIC_TEST_STAGES = 3;
+static const uint8_t CIC_TEST_RATE_LOG2 = 2;
+static const uint16_t CIC_TEST_OUTPUTS = 2048;
+static const uint16_t CIC_TEST_SETTLE = 64; // kimeneti mintak a meres elott
+
+// Oversample::readDecimated ugyanazon a bemeneten: 2^rateLog2 minta osszege, Q10.16-ra normalizalva
+struct BoxcarDecimator
+{
+    uint32_t sum = 0;
+    uint8_t phase = 0;
+    uint32_t value = 0;
+
+    inline bool push(uint16_t sample)
+    {
+        sum += sample;
+        if (++phase < (1U << CIC_TEST_RATE_LOG2))
+        {
+            return false;
+        }
+        value = sum << (16 - CIC_TEST_RATE_LOG2);
+        sum = 0;
+        phase = 0;
+        return true;
+    }
+    uint32_t output() const { return value; }
+};
+
+// Bemenet: 512 + 400 * sin, a frekvencia a kimeneti rata ezredreszeben; +-noise count zaj
+static uint16_t cicTestInput(uint32_t n, uint32_t freqMilli, uint16_t noise, uint32_t &rng)
+{
+    double phase = 2.0 * M_PI * freqMilli * n / (1000.0 * (1 << CIC_TEST_RATE_LOG2));
+    double value = 512.3 + (freqMilli ? 400.0 * sin(phase) : 0.0);
+    if (noise)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        value += static_cast<int16_t>(rng % (2 * noise + 1)) - noise;
+    }
+    return static_cast<uint16_t>(value + 0.5);
+}
+
+// A kimenet szorasa (AC resz): teszthangnal a bemeneti szinusz szorasahoz viszonyitva,
+// zajnal countban
+template <typename Decimator>
+static double response(Decimator &decimator, uint32_t freqMilli, uint16_t noise)
+{
+    uint32_t rng = 0x12345678u;
+    double sum = 0.0;
+    double squares = 0.0;
+    uint32_t outputs = 0;
+    for (uint32_t n = 0; outputs < CIC_TEST_OUTPUTS + CIC_TEST_SETTLE; ++n)
+    {
+        if (!decimator.push(cicTestInput(n, freqMilli, noise, rng)))
+        {
+            continue;
+        }
+        if (outputs++ < CIC_TEST_SETTLE)
+        {
+            continue;
+        }
+        double value = decimator.output() / 65536.0;
+        sum += value;
+        squares += value * value;
+    }
+    double mean = sum / CIC_TEST_OUTPUTS;
+    double variance = squares / CIC_TEST_OUTPUTS - mean * mean;
+    double sd = sqrt(variance > 0.0 ? variance : 0.0);
+    // 400 amplitudoju szinusz szorasa 400 / sqrt(2)
+    return freqMilli ? sd / (400.0 / M_SQRT2) : sd;
+}
+
+static CicDecimator cic;
+static CicDecimator cicComp;
+
+void setUp()
+{
+    TEST_ASSERT_TRUE(cic.configure(CIC_TEST_STAGES, CIC_TEST_RATE_LOG2, false));
+    TEST_ASSERT_TRUE(cicComp.configure(CIC_TEST_STAGES, CIC_TEST_RATE_LOG2, true));
+}
+
+void tearDown()
+{
+}
+
+void test_dc_is_exact()
+{
+    static const uint16_t levels[] = {0, 1, 511, 1023};
+    for (uint16_t level : levels)
+    {
+        cic.reset();
+        cicComp.reset();
+        for (uint16_t n = 0; n < 64; ++n)
+        {
+            if (cic.push(level))
+            {
+                TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(level) << CIC_OUTPUT_FRAC_BITS, cic.output());
+            }
+            if (cicComp.push(level))
+            {
+                TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(level) << CIC_OUTPUT_FRAC_BITS, cicComp.output());
+            }
+        }
+    }
+}
+
+void test_passband_gain()
+{
+    // 0.1 fout: a kompenzalt CIC gyakorlatilag 1.0
+    TEST_ASSERT_FLOAT_WITHIN(0.02, 1.0, response(cicComp, 100, 0));
+    TEST_ASSERT_FLOAT_WITHIN(0.06, 1.0, response(cic, 100, 0));
+
+    // 0.25 fout: a kompenzator a CIC droop nagy reszet visszahozza
+    double uncompensated = response(cic, 250, 0);
+    double compensated = response(cicComp, 250, 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.03, 0.744, uncompensated);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.9, compensated);
+    TEST_ASSERT_LESS_THAN_FLOAT(1.05, compensated);
+}
+
+void test_alias_rejection()
+{
+    // 0.75 es 1.25 fout a 0.25 fout-ra hajlik vissza: a CIC nullhelyei korul
+    static const uint16_t aliases[] = {750, 1250};
+    for (uint16_t tone : aliases)
+    {
+        BoxcarDecimator boxcar;
+        cic.reset();
+        cicComp.reset();
+        double boxcarGain = response(boxcar, tone, 0);
+        double cicGain = response(cic, tone, 0);
+        double compGain = response(cicComp, tone, 0);
+        // Legalabb 26 dB elnyomas, a boxcar tobbszorose
+        TEST_ASSERT_LESS_THAN_FLOAT(0.05, cicGain);
+        TEST_ASSERT_LESS_THAN_FLOAT(0.05, compGain);
+        TEST_ASSERT_GREATER_THAN_FLOAT(0.2, boxcarGain);
+        TEST_ASSERT_GREATER_THAN_FLOAT(5.0 * compGain, boxcarGain);
+    }
+}
+
+void test_noise()
+{
+    // +-3 count egyenletes zaj (szoras 2 count): a boxcar felezi, a CIC meg tobbet vag le
+    BoxcarDecimator boxcar;
+    double boxcarNoise = response(boxcar, 0, 3);
+    double cicNoise = response(cic, 0, 3);
+    double compNoise = response(cicComp, 0, 3);
+    TEST_ASSERT_FLOAT_WITHIN(0.1, 1.0, boxcarNoise);
+    TEST_ASSERT_LESS_THAN_FLOAT(boxcarNoise, cicNoise);
+    TEST_ASSERT_LESS_THAN_FLOAT(boxcarNoise, compNoise);
+}
+
+void test_register_width_limit()
+{
+    // stages * rateLog2 + 10 bit nem lehet tobb 32-nel
+    CicDecimator wide;
+    TEST_ASSERT_TRUE(wide.configure(CIC_MAX_STAGES, 5, true));
+    TEST_ASSERT_FALSE(wide.configure(CIC_MAX_STAGES, CIC_MAX_RATE_LOG2, true));
+    TEST_ASSERT_FALSE(wide.configure(CIC_MAX_STAGES + 1, 1, true));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_dc_is_exact);
+    RUN_TEST(test_passband_gain);
+    RUN_TEST(test_alias_rejection);
+    RUN_TEST(test_noise);
+    RUN_TEST(test_register_width_limit);
+    return UNITY_END();
+}
@@ -0,0 +1,273 @@
+//
+// Composite report descriptor: parsed item by item for each layout. Every
+// collection carries its own report ID, the input bits add up to the
+// device's report, no physical range/unit leaks from the hats into the
+// next device, and each report ID reaches the host from its own device.
+//   pio test -e native -f test_composite_descriptor
+//
+#include <unity.h>
+#include <CompositeGamepad.h>
+#include <SimHardware.h>
+
+using namespace arduino;
+
+// Egy top-level collection a parse-olas utan
+struct ParsedCollection
+{
+    uint8_t usage;
+    uint8_t reportId;
+    uint8_t reportIds;    // REPORT_ID elemek szama a collection-ben
+    uint16_t inputBits;
+    uint8_t axisInputs;   // nem hat tengely INPUT elemek
+    uint8_t leakedInputs; // tengely INPUT oroklott fizikai tartomannyal vagy egyseggel
+};
+
+struct ParsedDescriptor
+{
+    bool wellFormed;
+    uint8_t count;
+    ParsedCollection collections[COMPOSITE_MAX_DEVICES];
+};
+
+static int32_t itemValue(const uint8_t *data, uint8_t size)
+{
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < size; ++i)
+    {
+        value |= static_cast<uint32_t>(data[i]) << (8 * i);
+    }
+    return static_cast<int32_t>(value);
+}
+
+// Rovid HID elemek; a globalis allapot a collection-ok kozott is megmarad, mint a hoston
+static ParsedDescriptor parseDescriptor(const uint8_t *d, uint16_t length)
+{
+    ParsedDescriptor parsed;
+    memset(&parsed, 0, sizeof(parsed));
+    parsed.wellFormed = true;
+
+    uint8_t usagePage = 0, reportSize = 0, reportCount = 0, lastUsage = 0, pendingUsage = 0;
+    int32_t physicalMax = 0, unit = 0;
+    int8_t depth = 0;
+    ParsedCollection *current = nullptr;
+
+    uint16_t i = 0;
+    while (i < length)
+    {
+        uint8_t prefix = d[i];
+        uint8_t size = prefix & 0x03;
+        if (size == 3)
+        {
+            size = 4;
+        }
+        if (prefix == 0xFE || i + 1 + size > length)
+        {
+            parsed.wellFormed = false; // hosszu elem vagy csonka descriptor
+            return parsed;
+        }
+        uint8_t tag = prefix & 0xFC;
+        int32_t value = itemValue(&d[i + 1], size);
+
+        switch (tag)
+        {
+        case 0x04: usagePage = value; break;   // USAGE_PAGE
+        case 0x44: physicalMax = value; break; // PHYSICAL_MAXIMUM
+        case 0x64: unit = value; break;        // UNIT
+        case 0x74: reportSize = value; break;  // REPORT_SIZE
+        case 0x94: reportCount = value; break; // REPORT_COUNT
+        case 0x08:                             // USAGE
+            lastUsage = value;
+            if (depth == 0)
+            {
+                pendingUsage = value;
+            }
+            break;
+        case 0x84: // REPORT_ID
+            if (current == nullptr)
+            {
+                parsed.wellFormed = false;
+                return parsed;
+            }
+            current->reportId = value;
+            current->reportIds++;
+            break;
+        case 0xA0: // COLLECTION
+            if (depth == 0)
+            {
+                if (parsed.count >= COMPOSITE_MAX_DEVICES || value != 0x01)
+                {
+                    parsed.wellFormed = false;
+                    return parsed;
+                }
+                current = &parsed.collections[parsed.count++];
+                current->usage = pendingUsage;
+            }
+            depth++;
+            break;
+        case 0xC0: // END_COLLECTION
+            if (--depth < 0)
+            {
+                parsed.wellFormed = false;
+                return parsed;
+            }
+            if (depth == 0)
+            {
+                current = nullptr;
+            }
+            break;
+        case 0x80: // INPUT
+            if (current == nullptr)
+            {
+                parsed.wellFormed = false;
+                return parsed;
+            }
+            current->inputBits += reportSize * reportCount;
+            // Adat tengely (nem konstans kitoltes, nem hat)
+            if (!(value & 0x01) && usagePage == 0x01 && lastUsage != 0x39)
+            {
+                current->axisInputs++;
+                if (physicalMax != 0 || unit != 0)
+                {
+                    current->leakedInputs++;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+        i += 1 + size;
+    }
+    parsed.wellFormed = parsed.wellFormed && depth == 0;
+    return parsed;
+}
+
+static ParsedDescriptor parseComposite(CompositeGamepad &composite)
+{
+    const uint8_t *descriptor = composite.report_desc();
+    return parseDescriptor(descriptor, composite.report_desc_length());
+}
+
+static void checkLayouts(const GamepadLayout *layouts, uint8_t count)
+{
+    VirtualGamepad *devices[COMPOSITE_MAX_DEVICES];
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        devices[i] = new VirtualGamepad(layouts[i]);
+    }
+    CompositeGamepad composite(devices, count);
+
+    ParsedDescriptor parsed = parseComposite(composite);
+    TEST_ASSERT_TRUE(parsed.wellFormed);
+    TEST_ASSERT_EQUAL_UINT8(count, parsed.count);
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        const ParsedCollection &collection = parsed.collections[i];
+        VirtualGamepad &device = composite.device(i);
+        TEST_ASSERT_EQUAL_UINT8(layouts[i].usage, collection.usage);
+        TEST_ASSERT_EQUAL_UINT8(1, collection.reportIds);
+        TEST_ASSERT_EQUAL_UINT8(layouts[i].reportId, collection.reportId);
+        // A report ID bajt nem resze az INPUT elemeknek
+        TEST_ASSERT_EQUAL_UINT16(8 * (device.reportLength() - 1), collection.inputBits);
+        TEST_ASSERT_EQUAL_UINT8(layouts[i].axes ? 1 : 0, collection.axisInputs);
+        TEST_ASSERT_EQUAL_UINT8(0, collection.leakedInputs);
+    }
+
+    // Minden eszkoz a sajat report ID-javal, a sajat hosszaval megy ki
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        VirtualGamepad &device = composite.device(i);
+        device.setAxis(0, 1000 + i);
+        sim::advance(1000); // a host atvette az elozo reportot, az endpoint szabad
+        TEST_ASSERT_TRUE(composite.send_device(i, sim::now()));
+        const std::vector<uint8_t> &sent = sim::metrics().lastReport;
+        TEST_ASSERT_EQUAL_UINT32(device.reportLength(), sent.size());
+        TEST_ASSERT_EQUAL_UINT8(layouts[i].reportId, sent[0]);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(device.report(), sent.data(), sent.size());
+        TEST_ASSERT_FALSE(device.isDirty());
+    }
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        delete devices[i];
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// A firmware COMPOSITE_GAMEPAD felallasa (src/main.cpp)
+void test_firmware_layout()
+{
+    const GamepadLayout layouts[] = {
+        {1, 0x04, 0, 3, 0, 2000},
+        {2, 0x04, 0, 2, 0, 5000},
+        {3, 0x04, 0, 1, 0, 2000},
+    };
+    checkLayouts(layouts, 3);
+}
+
+// Hat-os eszkoz utan tengelyes: itt szivarogna at a 315 fokos fizikai maximum
+void test_axes_after_hats()
+{
+    const GamepadLayout layouts[] = {
+        {5, 0x05, 12, 2, 1, 1000},
+        {6, 0x04, 0, 4, 0, 2000},
+        {7, 0x05, 32, 8, 2, 1000},
+        {9, 0x04, 3, 1, 0, 4000},
+    };
+    checkLayouts(layouts, 4);
+}
+
+void test_buttons_and_hats_only()
+{
+    const GamepadLayout layouts[] = {
+        {1, 0x05, 5, 0, 2, 1000},
+        {2, 0x05, 16, 0, 1, 1000},
+    };
+    checkLayouts(layouts, 2);
+}
+
+// Csak a valtozott eszkoz megy ki, a sajat report ID-javal; host pollonkent legfeljebb egy,
+// foglalt endpointnal az eszkoz esedekes marad
+void test_poll_sends_only_dirty_device()
+{
+    VirtualGamepad first({1, 0x04, 0, 2, 0, 1000});
+    VirtualGamepad second({2, 0x04, 0, 2, 0, 1000});
+    VirtualGamepad *const devices[] = {&first, &second};
+    CompositeGamepad composite(devices, 2);
+
+    // Kezdetben mindketto dirty: egymas utan, egy-egy host pollban
+    sim::advance(1000);
+    uint32_t nowUs = 10000;
+    TEST_ASSERT_EQUAL_UINT8(1, composite.poll(nowUs));
+    TEST_ASSERT_EQUAL_UINT8(1, sim::metrics().lastReport[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, composite.poll(nowUs)); // endpoint foglalt
+    TEST_ASSERT_TRUE(second.isDirty());
+    sim::advance(1000);
+    TEST_ASSERT_EQUAL_UINT8(1, composite.poll(nowUs));
+    TEST_ASSERT_EQUAL_UINT8(2, sim::metrics().lastReport[0]);
+
+    second.setAxis(1, -1234);
+    nowUs += 2000;
+    sim::advance(1000);
+    uint32_t reports = sim::metrics().reports;
+    TEST_ASSERT_EQUAL_UINT8(1, composite.poll(nowUs));
+    TEST_ASSERT_EQUAL_UINT32(reports + 1, sim::metrics().reports);
+    TEST_ASSERT_EQUAL_UINT8(2, sim::metrics().lastReport[0]);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_firmware_layout);
+    RUN_TEST(test_axes_after_hats);
+    RUN_TEST(test_buttons_and_hats_only);
+    RUN_TEST(test_poll_sends_only_dirty_device);
+    return UNITY_END();
+}
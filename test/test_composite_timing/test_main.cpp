@@ -0,0 +1,109 @@
+//
+// Composite gamepad under the scheduler, as in the COMPOSITE_GAMEPAD
+// firmware: 500 us acquisition and a 1 ms report task polling three
+// devices whose axes change every frame. The report task must never wait
+// for the host, so acquisition misses no deadline, and the devices share
+// the one report per host poll in turn.
+//   pio test -e native -f test_composite_timing
+//
+#include <unity.h>
+#include <CompositeGamepad.h>
+#include <MCP3008Reader.h>
+#include <Scheduler.h>
+#include <SimHardware.h>
+
+using namespace arduino;
+
+static const uint32_t TIMING_ACQUISITION_US = 500;
+static const uint32_t TIMING_REPORT_US = 1000;
+static const uint32_t TIMING_RUN_US = 2000000;
+static const uint32_t TIMING_HOST_POLL_US = 1000;
+
+static Adafruit_MCP3008 adc;
+static MCP3008Reader reader(&adc, CHANNEL_COUNT, 21);
+
+// A firmware composite eszkozei
+static VirtualGamepad pedals({1, 0x04, 0, 3, 0, 2000});
+static VirtualGamepad throttle({2, 0x04, 0, 2, 0, 5000});
+static VirtualGamepad handWheel({3, 0x04, 0, 1, 0, 2000});
+static VirtualGamepad *const gamepads[] = {&pedals, &throttle, &handWheel};
+static CompositeGamepad composite(gamepads, 3);
+
+static uint32_t reportsById[4];
+
+static void acquisitionTaskFn(void *)
+{
+    reader.readChannelsWithEMA();
+}
+
+static void reportTaskFn(void *)
+{
+    // Minden eszkoz minden frame-ben valtozik
+    for (uint8_t d = 0; d < 3; ++d)
+    {
+        for (uint8_t axis = 0; axis < gamepads[d]->layout().axes; ++axis)
+        {
+            gamepads[d]->setAxis(axis, static_cast<int16_t>(reader.getRawValue(d * 3 + axis) * 32));
+        }
+    }
+    if (composite.poll(micros()))
+    {
+        reportsById[sim::metrics().lastReport[0] & 3]++;
+    }
+}
+
+void setUp()
+{
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch)
+    {
+        sim::Waveform wave;
+        wave.type = sim::WAVE_SINE;
+        wave.periodS = 0.1;
+        wave.amplitude = 400.0;
+        wave.noise = 2.0;
+        sim::setWaveform(ch, wave);
+    }
+    sim::usbSetPollInterval(TIMING_HOST_POLL_US);
+}
+
+void tearDown()
+{
+}
+
+void test_acquisition_meets_deadlines()
+{
+    Scheduler scheduler;
+    int8_t acquisition = scheduler.addTask("acquisition", acquisitionTaskFn, nullptr, TIMING_ACQUISITION_US, 0);
+    int8_t report = scheduler.addTask("report", reportTaskFn, nullptr, TIMING_REPORT_US, 1);
+    TEST_ASSERT_TRUE(acquisition >= 0 && report >= 0);
+
+    uint32_t start = micros();
+    while (micros() - start < TIMING_RUN_US)
+    {
+        scheduler.run();
+    }
+
+    const TaskStats &acquisitionStats = scheduler.task(acquisition).stats;
+    const TaskStats &reportStats = scheduler.task(report).stats;
+    TEST_ASSERT_GREATER_THAN_UINT32(TIMING_RUN_US / TIMING_ACQUISITION_US - 2, acquisitionStats.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, acquisitionStats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(0, acquisitionStats.skipped);
+    TEST_ASSERT_EQUAL_UINT32(0, reportStats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(0, reportStats.skipped);
+    // A report task nem var a hostra: a futasa nem tolja ki a kovetkezo acquisition-t
+    TEST_ASSERT_LESS_THAN_UINT32(TIMING_ACQUISITION_US, reportStats.maxRunUs);
+
+    // Hostonkenti pollonkent egy report; a 2 ms-os eszkozok egyforman, a 5 ms-os a sajat rataja szerint
+    uint32_t total = reportsById[1] + reportsById[2] + reportsById[3];
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(TIMING_RUN_US / TIMING_HOST_POLL_US, total);
+    TEST_ASSERT_UINT32_WITHIN(TIMING_RUN_US / 20000, TIMING_RUN_US / 5000, reportsById[2]);
+    TEST_ASSERT_UINT32_WITHIN(TIMING_RUN_US / 20000, reportsById[1], reportsById[3]);
+    TEST_ASSERT_GREATER_THAN_UINT32(TIMING_RUN_US / 4000, reportsById[1]);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_acquisition_meets_deadlines);
+    return UNITY_END();
+}
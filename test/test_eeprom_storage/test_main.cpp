@@ -0,0 +1,123 @@
+//
+// EEPROMStorage write status over the I2CBus queue and the simulated
+// 24LC64: the combined status of one save stays FAILED when a later write
+// of the same save succeeds, and the data lands in the EEPROM.
+//   pio test -e native -f test_eeprom_storage
+//
+#include <unity.h>
+#include <EEPROMStorage.h>
+#include <Wire.h>
+#include <SimHardware.h>
+
+static const uint8_t TEST_EEPROM_ADDRESS = 0x50;
+static const uint16_t TEST_MEMORY_ADDRESS = 0x1000;
+
+static arduino::MbedI2C wire(6, 7);
+static I2CBus bus(&wire);
+static EEPROMStorage storage(&bus, TEST_EEPROM_ADDRESS);
+
+// A busz task futtatasa, amig a sor kiurul
+static void runBus()
+{
+    for (uint16_t i = 0; i < 1000 && !bus.idle(); ++i)
+    {
+        sim::advance(100);
+        bus.service();
+    }
+    TEST_ASSERT_TRUE(bus.idle());
+}
+
+void setUp()
+{
+    static bool started = false;
+    if (!started)
+    {
+        bus.addDevice(TEST_EEPROM_ADDRESS, I2C_FAST_MODE_HZ);
+        bus.begin();
+        started = true;
+    }
+    sim::setI2CDevicePresent(TEST_EEPROM_ADDRESS, true);
+    storage.clearWriteStatus();
+}
+
+void tearDown()
+{
+}
+
+void test_writes_complete()
+{
+    const uint8_t first[] = {1, 2, 3, 4};
+    const uint8_t second[] = {5, 6};
+    TEST_ASSERT_TRUE(storage.write(TEST_MEMORY_ADDRESS, first, sizeof(first)));
+    TEST_ASSERT_TRUE(storage.write(TEST_MEMORY_ADDRESS + sizeof(first), second, sizeof(second)));
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_PENDING, storage.writeStatus());
+    runBus();
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_DONE, storage.writeStatus());
+
+    uint8_t readBack[sizeof(first) + sizeof(second)];
+    TEST_ASSERT_TRUE(storage.read(TEST_MEMORY_ADDRESS, readBack, sizeof(readBack)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(first, readBack, sizeof(first));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(second, readBack + sizeof(first), sizeof(second));
+}
+
+void test_later_success_keeps_failure()
+{
+    // Az elso iras alatt nincs eszkoz, a masodik mar sikeres
+    const uint8_t header[] = {0xA5, 0x5A};
+    const uint8_t record[] = {7, 8, 9};
+    sim::setI2CDevicePresent(TEST_EEPROM_ADDRESS, false);
+    TEST_ASSERT_TRUE(storage.write(TEST_MEMORY_ADDRESS, header, sizeof(header)));
+    runBus();
+    sim::setI2CDevicePresent(TEST_EEPROM_ADDRESS, true);
+    TEST_ASSERT_TRUE(storage.write(TEST_MEMORY_ADDRESS + 64, record, sizeof(record)));
+    runBus();
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_FAILED, storage.writeStatus());
+
+    storage.clearWriteStatus();
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_DONE, storage.writeStatus());
+}
+
+void test_failure_survives_status_reuse()
+{
+    // A hibas iras allapot helyet a kovetkezo I2C_QUEUE_LENGTH iras ujrahasznalja
+    const uint8_t data[] = {0x11};
+    sim::setI2CDevicePresent(TEST_EEPROM_ADDRESS, false);
+    TEST_ASSERT_TRUE(storage.write(TEST_MEMORY_ADDRESS, data, sizeof(data)));
+    runBus();
+    sim::setI2CDevicePresent(TEST_EEPROM_ADDRESS, true);
+    for (uint8_t i = 0; i < 2 * I2C_QUEUE_LENGTH; ++i)
+    {
+        TEST_ASSERT_TRUE(storage.write(TEST_MEMORY_ADDRESS + i, data, sizeof(data)));
+        runBus();
+    }
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_FAILED, storage.writeStatus());
+}
+
+// A lap iras utani iras ciklusban a chip NACK-zik: egy masodik mentes sem latja hianyzonak
+void test_available_during_write_cycle()
+{
+    const uint8_t data[] = {0x42, 0x43};
+    TEST_ASSERT_TRUE(storage.isAvailable());
+    TEST_ASSERT_TRUE(storage.write(TEST_MEMORY_ADDRESS, data, sizeof(data)));
+    sim::advance(100);
+    bus.service();
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_PENDING, storage.writeStatus());
+    TEST_ASSERT_FALSE(bus.probe(TEST_EEPROM_ADDRESS));
+    TEST_ASSERT_TRUE(storage.isAvailable());
+    runBus();
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_DONE, storage.writeStatus());
+
+    // Iras nelkul ujra a cim proba dont
+    sim::setI2CDevicePresent(TEST_EEPROM_ADDRESS, false);
+    TEST_ASSERT_FALSE(storage.isAvailable());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_writes_complete);
+    RUN_TEST(test_later_success_keeps_failure);
+    RUN_TEST(test_failure_survives_status_reuse);
+    RUN_TEST(test_available_during_write_cycle);
+    return UNITY_END();
+}
@@ -0,0 +1,193 @@
+//
+// FlashStorage on the simulated QSPI flash: a committed image reads back
+// after begin(); a power cut after any number of programmed pages leaves
+// the previous image in use; begin() picks the newer sector by sequence,
+// across the 32-bit wrap; a sector with a bad magic, length or CRC is
+// never used.
+//   pio test -e native -f test_flash_storage
+//
+#include <unity.h>
+#include <FlashStorage.h>
+#include <SimHardware.h>
+#include <string.h>
+
+static const uint32_t TEST_FLASH_OFFSET = 1024 * 1024;
+static const uint16_t TEST_IMAGE_SIZE = 600; // fejleccel 3 lap
+
+static uint8_t shadow[TEST_IMAGE_SIZE];
+
+static void fillImage(uint8_t *image, uint8_t seed)
+{
+    for (uint16_t i = 0; i < TEST_IMAGE_SIZE; ++i)
+    {
+        image[i] = static_cast<uint8_t>(seed + i * 7);
+    }
+}
+
+static uint32_t sectorOffset(uint8_t sector)
+{
+    return TEST_FLASH_OFFSET + sector * FLASH_STORAGE_SECTOR;
+}
+
+// Egy szektor kezzel irva, a FlashStorage formatumaban (a CRC es a hossz elronthato)
+static void programRecord(uint8_t sector, uint32_t sequence, uint8_t seed, uint16_t crcXor = 0, uint16_t length = TEST_IMAGE_SIZE)
+{
+    uint8_t bytes[FLASH_STORAGE_SECTOR];
+    memset(bytes, 0xFF, sizeof(bytes));
+    uint8_t *image = bytes + sizeof(FlashRecordHeader);
+    fillImage(image, seed);
+    uint16_t crc = storageCrc16(&sequence, sizeof(sequence));
+    crc = storageCrc16(&TEST_IMAGE_SIZE, sizeof(TEST_IMAGE_SIZE), crc);
+    crc = storageCrc16(image, TEST_IMAGE_SIZE, crc);
+    FlashRecordHeader header = {FLASH_STORAGE_MAGIC, sequence, length, static_cast<uint16_t>(crc ^ crcXor)};
+    memcpy(bytes, &header, sizeof(header));
+    sim::flashErase(sectorOffset(sector), FLASH_STORAGE_SECTOR);
+    sim::flashProgram(sectorOffset(sector), bytes, sizeof(bytes));
+}
+
+static void eraseSectors()
+{
+    sim::flashErase(TEST_FLASH_OFFSET, 2 * FLASH_STORAGE_SECTOR);
+}
+
+// Uj peldany, mint egy ujrainditas utan
+static bool imageAfterBoot(FlashStorage &storage, uint8_t seed)
+{
+    uint8_t expected[TEST_IMAGE_SIZE];
+    uint8_t image[TEST_IMAGE_SIZE];
+    fillImage(expected, seed);
+    return storage.begin() && storage.read(0, image, sizeof(image)) && memcmp(expected, image, sizeof(image)) == 0;
+}
+
+static bool commitImage(FlashStorage &storage, uint8_t seed)
+{
+    uint8_t image[TEST_IMAGE_SIZE];
+    fillImage(image, seed);
+    return storage.write(0, image, sizeof(image)) && storage.commit();
+}
+
+void setUp()
+{
+    sim::setFlashPowerCut(-1);
+    eraseSectors();
+}
+
+void tearDown()
+{
+    sim::setFlashPowerCut(-1);
+}
+
+void test_round_trip()
+{
+    FlashStorage storage(TEST_FLASH_OFFSET, shadow, TEST_IMAGE_SIZE);
+    uint8_t image[TEST_IMAGE_SIZE];
+    TEST_ASSERT_FALSE(storage.begin()); // ures flash
+    TEST_ASSERT_FALSE(storage.read(0, image, sizeof(image)));
+    TEST_ASSERT_TRUE(commitImage(storage, 1));
+    TEST_ASSERT_FALSE(storage.dirty());
+    TEST_ASSERT_TRUE(commitImage(storage, 2));
+    TEST_ASSERT_EQUAL_UINT32(2, storage.commits());
+
+    FlashStorage rebooted(TEST_FLASH_OFFSET, shadow, TEST_IMAGE_SIZE);
+    TEST_ASSERT_TRUE(imageAfterBoot(rebooted, 2));
+    TEST_ASSERT_EQUAL_UINT32(2, rebooted.sequence());
+    TEST_ASSERT_EQUAL_INT8(storage.activeSector(), rebooted.activeSector());
+}
+
+// Az uj kep 3 lapja kozul 0, 1 vagy 2 kerul ki (a fejlec lap az utolso): mindig az elozo kep marad
+void test_power_cut_keeps_previous_image()
+{
+    for (int32_t pages = 0; pages < 3; ++pages)
+    {
+        eraseSectors();
+        FlashStorage storage(TEST_FLASH_OFFSET, shadow, TEST_IMAGE_SIZE);
+        storage.begin();
+        TEST_ASSERT_TRUE(commitImage(storage, 10));
+        TEST_ASSERT_TRUE(commitImage(storage, 20));
+
+        sim::setFlashPowerCut(pages);
+        TEST_ASSERT_FALSE(commitImage(storage, 30));
+        TEST_ASSERT_EQUAL_UINT32(1, storage.failures());
+        TEST_ASSERT_TRUE(storage.dirty()); // a shadow megmaradt, ujra menthet
+        sim::setFlashPowerCut(-1);
+
+        FlashStorage rebooted(TEST_FLASH_OFFSET, shadow, TEST_IMAGE_SIZE);
+        TEST_ASSERT_TRUE(imageAfterBoot(rebooted, 20));
+        TEST_ASSERT_EQUAL_UINT32(2, rebooted.sequence());
+    }
+}
+
+void test_newest_sector_wins()
+{
+    FlashStorage storage(TEST_FLASH_OFFSET, shadow, TEST_IMAGE_SIZE);
+    programRecord(0, 5, 50);
+    programRecord(1, 4, 40);
+    TEST_ASSERT_TRUE(imageAfterBoot(storage, 50));
+    TEST_ASSERT_EQUAL_INT8(0, storage.activeSector());
+
+    programRecord(0, 6, 60);
+    programRecord(1, 7, 70);
+    TEST_ASSERT_TRUE(imageAfterBoot(storage, 70));
+    TEST_ASSERT_EQUAL_INT8(1, storage.activeSector());
+}
+
+// 0xFFFFFFFF utan a 0 az ujabb; a kovetkezo commit 1-gyel a masik szektorba megy
+void test_sequence_wrap()
+{
+    FlashStorage storage(TEST_FLASH_OFFSET, shadow, TEST_IMAGE_SIZE);
+    programRecord(0, 0xFFFFFFFFu, 80);
+    programRecord(1, 0, 90);
+    TEST_ASSERT_TRUE(imageAfterBoot(storage, 90));
+    TEST_ASSERT_EQUAL_INT8(1, storage.activeSector());
+
+    programRecord(0, 0xFFFFFFFEu, 80);
+    programRecord(1, 0xFFFFFFFFu, 90);
+    TEST_ASSERT_TRUE(imageAfterBoot(storage, 90));
+    TEST_ASSERT_TRUE(commitImage(storage, 100));
+    TEST_ASSERT_EQUAL_INT8(0, storage.activeSector());
+    TEST_ASSERT_EQUAL_UINT32(0, storage.sequence());
+
+    FlashStorage rebooted(TEST_FLASH_OFFSET, shadow, TEST_IMAGE_SIZE);
+    TEST_ASSERT_TRUE(imageAfterBoot(rebooted, 100));
+}
+
+// Az ujabb szektor hibas: a regebbi ervenyes marad; ha az is hibas, nincs kep
+void test_corrupt_sector_rejected()
+{
+    FlashStorage storage(TEST_FLASH_OFFSET, shadow, TEST_IMAGE_SIZE);
+
+    programRecord(0, 1, 11);
+    programRecord(1, 2, 22, 0x0001); // CRC
+    TEST_ASSERT_TRUE(imageAfterBoot(storage, 11));
+    TEST_ASSERT_EQUAL_INT8(0, storage.activeSector());
+
+    programRecord(1, 2, 22, 0, TEST_IMAGE_SIZE - 1); // hossz
+    TEST_ASSERT_TRUE(imageAfterBoot(storage, 11));
+
+    // Magic: a fejlec elso bajtja torolve (NOR programozas csak 1 -> 0 bitet ir)
+    programRecord(1, 2, 22);
+    TEST_ASSERT_TRUE(imageAfterBoot(storage, 22));
+    uint8_t page[FLASH_STORAGE_PAGE];
+    memset(page, 0xFF, sizeof(page));
+    page[0] = 0x00;
+    sim::flashProgram(sectorOffset(1), page, sizeof(page));
+    TEST_ASSERT_TRUE(imageAfterBoot(storage, 11));
+
+    // Adat bit hiba a regebbi szektorban is
+    memset(page, 0xFF, sizeof(page));
+    page[sizeof(FlashRecordHeader)] = 0x00;
+    sim::flashProgram(sectorOffset(0), page, sizeof(page));
+    TEST_ASSERT_FALSE(storage.begin());
+    TEST_ASSERT_EQUAL_INT8(-1, storage.activeSector());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_power_cut_keeps_previous_image);
+    RUN_TEST(test_newest_sector_wins);
+    RUN_TEST(test_sequence_wrap);
+    RUN_TEST(test_corrupt_sector_rejected);
+    return UNITY_END();
+}
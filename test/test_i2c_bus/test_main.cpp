@@ -0,0 +1,115 @@
+//
+// I2CBus on the simulated Wire1 devices: one service() run never uses more
+// bus time than the budget (long display flushes and EEPROM writes are
+// chunked to fit), and an EEPROM that ACKs its address but NACKs the data
+// fails the write after I2C_WRITE_RETRIES instead of holding the queue.
+//   pio test -e native -f test_i2c_bus
+//
+#include <unity.h>
+#include <I2CBus.h>
+#include <Wire.h>
+#include <SimHardware.h>
+
+static const uint8_t TEST_EEPROM_ADDRESS = 0x50;
+static const uint8_t TEST_DISPLAY_ADDRESS = 0x3C;
+static const uint16_t TEST_FRAME_BYTES = 1024; // SSD1306 128x64
+
+static arduino::MbedI2C wire(6, 7);
+static I2CBus bus(&wire);
+static uint8_t frame[TEST_FRAME_BYTES];
+
+// service() hivasok, amig a sor kiurul; a leghosszabb futas busz ideje
+static uint32_t runBus(uint32_t *runs = nullptr)
+{
+    uint32_t longestRunUs = 0;
+    uint32_t count = 0;
+    for (; count < 5000 && !bus.idle(); ++count)
+    {
+        sim::advance(100);
+        uint64_t busyUs = sim::metrics().i2cBusyUs;
+        bus.service();
+        uint32_t runUs = static_cast<uint32_t>(sim::metrics().i2cBusyUs - busyUs);
+        longestRunUs = runUs > longestRunUs ? runUs : longestRunUs;
+    }
+    TEST_ASSERT_TRUE(bus.idle());
+    if (runs)
+    {
+        *runs = count;
+    }
+    return longestRunUs;
+}
+
+void setUp()
+{
+    static bool started = false;
+    if (!started)
+    {
+        bus.addDevice(TEST_EEPROM_ADDRESS, I2C_FAST_MODE_HZ);
+        bus.addDevice(TEST_DISPLAY_ADDRESS, I2C_FAST_MODE_PLUS_HZ);
+        bus.begin();
+        started = true;
+    }
+    sim::setI2CDevicePresent(TEST_EEPROM_ADDRESS, true);
+    sim::setI2CDevicePresent(TEST_DISPLAY_ADDRESS, true);
+    sim::setEepromDataNack(false);
+    bus.setBudget(I2C_DEFAULT_BUDGET_US);
+}
+
+void tearDown()
+{
+}
+
+void test_run_stays_within_budget()
+{
+    // A legkisebb budget a kijelzo ablak parancsa (8 bajt, 400 kHz-en 180 us), az nem darabolhato
+    static const uint32_t budgets[] = {200, 300, I2C_DEFAULT_BUDGET_US};
+    uint8_t data[3 * I2C_EEPROM_PAGE];
+    for (uint16_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i);
+    }
+    for (uint32_t budget : budgets)
+    {
+        bus.setBudget(budget);
+        volatile I2CJobStatus flushStatus;
+        volatile I2CJobStatus writeStatus;
+        TEST_ASSERT_TRUE(bus.flushDisplay(TEST_DISPLAY_ADDRESS, frame, sizeof(frame), &flushStatus));
+        TEST_ASSERT_TRUE(bus.writeMemory(TEST_EEPROM_ADDRESS, 0x0010, data, sizeof(data), &writeStatus));
+        uint32_t runs = 0;
+        uint32_t longestRunUs = runBus(&runs);
+        TEST_ASSERT_EQUAL_UINT8(I2C_JOB_DONE, flushStatus);
+        TEST_ASSERT_EQUAL_UINT8(I2C_JOB_DONE, writeStatus);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(budget, longestRunUs);
+        // A frame darabolva, tobb futas alatt ment at
+        TEST_ASSERT_GREATER_THAN_UINT32(1, runs);
+    }
+}
+
+void test_data_nack_fails_after_retries()
+{
+    const uint8_t data[] = {1, 2, 3, 4};
+    volatile I2CJobStatus writeStatus;
+    volatile I2CJobStatus flushStatus;
+    sim::setEepromDataNack(true);
+    uint64_t writesBefore = sim::metrics().eepromWrites;
+    TEST_ASSERT_TRUE(bus.writeMemory(TEST_EEPROM_ADDRESS, 0x0100, data, sizeof(data), &writeStatus));
+    TEST_ASSERT_TRUE(bus.flushDisplay(TEST_DISPLAY_ADDRESS, frame, sizeof(frame), &flushStatus));
+    runBus();
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_FAILED, writeStatus);
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_DONE, flushStatus);
+    TEST_ASSERT_EQUAL_UINT32(0, static_cast<uint32_t>(sim::metrics().eepromWrites - writesBefore));
+
+    // Utana a chip ujra jo: a sor nem ragadt be, a kovetkezo iras sikeres
+    sim::setEepromDataNack(false);
+    TEST_ASSERT_TRUE(bus.writeMemory(TEST_EEPROM_ADDRESS, 0x0100, data, sizeof(data), &writeStatus));
+    runBus();
+    TEST_ASSERT_EQUAL_UINT8(I2C_JOB_DONE, writeStatus);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_run_stays_within_budget);
+    RUN_TEST(test_data_nack_fails_after_retries);
+    return UNITY_END();
+}
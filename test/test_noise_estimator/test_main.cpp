@@ -0,0 +1,78 @@
+//
+// NoiseEstimator on Q10.16 samples: sub-count noise (as left after CIC
+// decimation or ratiometric correction) is measured, not rounded away;
+// whole-count noise gives its exact variance; a moving axis never counts
+// as rest.
+//   pio test -e native -f test_noise_estimator
+//
+#include <unity.h>
+#include <NoiseEstimator.h>
+
+static void feedBlocks(NoiseEstimator &estimator, uint8_t blocks, uint32_t (*sample)(uint32_t))
+{
+    for (uint32_t i = 0; i < static_cast<uint32_t>(blocks) * NOISE_BLOCK; ++i)
+    {
+        estimator.add(sample(i));
+        estimator.process();
+    }
+}
+
+// 500.25 / 500.75 felvaltva: variancia 0.0625 count^2, egesz mintakbol 0 vagy 0.25 lenne
+static uint32_t quarterCountNoise(uint32_t i)
+{
+    return (500UL << 16) + ((i & 1) ? 0xC000 : 0x4000);
+}
+
+// 400 +- 1 count felvaltva: variancia 1 count^2
+static uint32_t wholeCountNoise(uint32_t i)
+{
+    return (i & 1) ? (401UL << 16) : (399UL << 16);
+}
+
+// 2 count / blokk rampa
+static uint32_t ramp(uint32_t i)
+{
+    return (300UL << 16) + i * (2UL << 16) / NOISE_BLOCK;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_sub_count_noise()
+{
+    NoiseEstimator estimator;
+    feedBlocks(estimator, NOISE_MIN_REST_BLOCKS + 2, quarterCountNoise);
+    TEST_ASSERT_TRUE(estimator.hasEstimate());
+    TEST_ASSERT_EQUAL_UINT32(16, estimator.varianceQ8()); // 0.0625 * 256
+}
+
+void test_whole_count_noise()
+{
+    NoiseEstimator estimator;
+    feedBlocks(estimator, NOISE_MIN_REST_BLOCKS + 2, wholeCountNoise);
+    TEST_ASSERT_TRUE(estimator.hasEstimate());
+    TEST_ASSERT_EQUAL_UINT32(256, estimator.varianceQ8());
+}
+
+void test_moving_axis_is_not_rest()
+{
+    NoiseEstimator estimator;
+    feedBlocks(estimator, NOISE_MIN_REST_BLOCKS + 2, ramp);
+    TEST_ASSERT_FALSE(estimator.hasEstimate());
+    TEST_ASSERT_EQUAL_UINT32(0, estimator.restBlocks());
+    TEST_ASSERT_EQUAL_UINT32(NOISE_MIN_REST_BLOCKS + 2, estimator.movingBlocks());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sub_count_noise);
+    RUN_TEST(test_whole_count_noise);
+    RUN_TEST(test_moving_axis_is_not_rest);
+    return UNITY_END();
+}
@@ -0,0 +1,241 @@
+//
+// AxisPredictor against the plain EMA path on a recorded axis trace
+// (axis_trace.csv, stream_decode.py format: raw0 at rest, raw2 triangle
+// strokes with reversals, raw5 smooth sine). The trace is replayed through
+// the simulated MCP3008 into MCP3008Reader at 2 kHz. At rest the predicted
+// value must be as noisy as the EMA shift whose noise on the trace matches
+// it, within 1.2x, and lag less than that EMA; on the moving columns it
+// must lag far less than the default EMA. On white noise the tracker
+// itself must match the EMA's noise.
+//   pio test -e native -f test_predictor
+//
+#include <unity.h>
+#include <MCP3008Reader.h>
+#include <SimHardware.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+static const uint32_t FRAME_US = 500;            // acquisition periodus
+static const uint32_t POLL_LEAD_US = 500;        // fel USB poll intervallum, mint a firmware-ben
+static const uint32_t SETTLE_FRAMES = 6000;      // a prediktor beallasa (az EMA-nal lassabb, theta^n * n)
+static const uint32_t WHITE_SETTLE_SAMPLES = 4000;
+static const uint8_t MATCH_SHIFT_MIN = 4;        // a legkisebb vizsgalt EMA shift
+static const double NOISE_PARITY = 1.2;
+static const uint32_t REFERENCE_HALF_US = 8000;  // kozepre igazitott atlag a nyomvonalbol: nincs kesese
+static const int32_t LAG_SEARCH_MIN = -20;       // frame-ben
+static const int32_t LAG_SEARCH_MAX = 600;
+
+static Adafruit_MCP3008 adc;
+static MCP3008Reader reader(&adc, CHANNEL_COUNT, 21);
+
+// Egy csatorna kimenete frame-enkent, a nyomvonalbol szamolt referenciaval
+struct AxisRun
+{
+    std::vector<double> reference;
+    std::vector<double> ema;
+    std::vector<double> predicted; // a host poll idopontjara extrapolalva (ez megy a reportba)
+    std::vector<double> raw;
+};
+
+static std::string tracePath()
+{
+    std::string file = __FILE__;
+    size_t slash = file.find_last_of('/');
+    return (slash == std::string::npos ? std::string() : file.substr(0, slash + 1)) + "axis_trace.csv";
+}
+
+// Kesleltetes nelkuli referencia: a nyomvonal mintainak atlaga +-REFERENCE_HALF_US ablakban
+static double referenceAt(const sim::Waveform &wave, uint64_t us)
+{
+    uint64_t t = us % (wave.traceUs.back() + 1);
+    double sum = 0.0;
+    uint32_t count = 0;
+    for (size_t i = 0; i < wave.traceUs.size(); ++i)
+    {
+        uint64_t sample = wave.traceUs[i];
+        if (sample + REFERENCE_HALF_US >= t && sample <= t + REFERENCE_HALF_US)
+        {
+            sum += wave.traceValues[i];
+            count++;
+        }
+    }
+    return count ? sum / count : 0.0;
+}
+
+// A nyomvonal egy teljes lejatszasa a readeren; a prediktor az alapertelmezett
+// erositesekkel fut, az EMA a megadott shifttel
+static AxisRun runTrace(uint8_t channel, const char *column, uint8_t emaShift = EMA_SHIFT)
+{
+    sim::Waveform wave;
+    std::string spec = std::string("trace,") + tracePath() + "," + column;
+    TEST_ASSERT_TRUE_MESSAGE(sim::parseWaveform(spec, wave), "axis_trace.csv");
+    sim::setWaveform(channel, wave);
+
+    reader.setMedianWindow(channel, 1);
+    reader.setPredictionTiming(FRAME_US, POLL_LEAD_US);
+    reader.setPredictorEnabled(channel, true);
+    reader.setEmaShift(channel, emaShift);
+    reader.predictor(channel).setGains(PREDICTOR_DEFAULT_ALPHA, PREDICTOR_DEFAULT_BETA);
+
+    AxisRun run;
+    uint32_t frames = static_cast<uint32_t>((wave.traceUs.back() + 1) / FRAME_US);
+    for (uint32_t frame = 0; frame < SETTLE_FRAMES + frames; ++frame)
+    {
+        sim::advance(FRAME_US - (sim::now() % FRAME_US));
+        uint64_t frameUs = sim::now();
+        reader.readChannelsWithEMA();
+        if (frame < SETTLE_FRAMES)
+        {
+            continue;
+        }
+        run.reference.push_back(referenceAt(wave, frameUs));
+        run.ema.push_back(reader.getFilteredQ16(channel) / 65536.0);
+        run.predicted.push_back(reader.getPredictedValue(channel) / 65536.0);
+        run.raw.push_back(reader.getRawValue(channel));
+    }
+    return run;
+}
+
+// Az a kesleltetes (us), amellyel a kimenet legjobban illeszkedik a referenciara
+static double lagUs(const std::vector<double> &output, const std::vector<double> &reference)
+{
+    int32_t best = 0;
+    double bestError = 1e300;
+    for (int32_t d = LAG_SEARCH_MIN; d <= LAG_SEARCH_MAX; ++d)
+    {
+        double error = 0.0;
+        for (size_t i = LAG_SEARCH_MAX; i + (-LAG_SEARCH_MIN) < output.size(); ++i)
+        {
+            double diff = output[i] - reference[i - d];
+            error += diff * diff;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            best = d;
+        }
+    }
+    return static_cast<double>(best) * FRAME_US;
+}
+
+// Kimeneti szoras nyugalomban (a bemenet allando, csak zaj)
+static double noise(const std::vector<double> &output)
+{
+    double sum = 0.0;
+    double squares = 0.0;
+    for (double value : output)
+    {
+        sum += value;
+        squares += value * value;
+    }
+    double mean = sum / output.size();
+    double variance = squares / output.size() - mean * mean;
+    return sqrt(variance > 0.0 ? variance : 0.0);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Az az EMA shift, amelynek a zaja a nyomvonalon a legkozelebb van a prediktorehoz
+// (aranyban); a prediktor ezzel zajparitasban, es kisebb kesessel
+void test_noise_at_rest()
+{
+    AxisRun run = runTrace(CHANNEL_THROTTLE_LEFT, "raw0");
+    double predictedNoise = noise(run.predicted);
+    TEST_ASSERT_GREATER_THAN_FLOAT(1.0, noise(run.raw));
+
+    uint8_t matchedShift = EMA_SHIFT;
+    double matchedNoise = 0.0;
+    for (uint8_t shift = EMA_SHIFT; shift >= MATCH_SHIFT_MIN; --shift)
+    {
+        double emaNoise = noise(runTrace(CHANNEL_THROTTLE_LEFT, "raw0", shift).ema);
+        if (matchedNoise == 0.0 || fabs(log(emaNoise / predictedNoise)) < fabs(log(matchedNoise / predictedNoise)))
+        {
+            matchedShift = shift;
+            matchedNoise = emaNoise;
+        }
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(NOISE_PARITY * matchedNoise, predictedNoise);
+    TEST_ASSERT_LESS_THAN_FLOAT(NOISE_PARITY * predictedNoise, matchedNoise);
+    // Az alapertelmezett erositesek az 1/256 EMA zajara vannak hangolva, a nyomvonalon is
+    TEST_ASSERT_EQUAL_UINT8(EMA_SHIFT, matchedShift);
+
+    AxisRun strokes = runTrace(CHANNEL_RUDDER, "raw2", matchedShift);
+    TEST_ASSERT_LESS_THAN_FLOAT(lagUs(strokes.ema, strokes.reference), fabs(lagUs(strokes.predicted, strokes.reference)));
+}
+
+// Feher zajon (mintankent fuggetlen, +-3 count) az alapertelmezett erositesek ugyanannyi
+// nyugalmi zajt adnak, mint az 1/256 EMA
+void test_white_noise_matches_ema()
+{
+    AxisPredictor predictor;
+    uint32_t ema = 400UL << 16;
+    uint32_t rng = 0x12345678u;
+    std::vector<double> emaOut;
+    std::vector<double> trackedOut;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        uint16_t sample = 400 + static_cast<int16_t>(rng % 7) - 3;
+        ema += static_cast<int32_t>((static_cast<uint32_t>(sample) << 16) - ema) >> EMA_SHIFT;
+        predictor.update(sample);
+        if (i >= WHITE_SETTLE_SAMPLES)
+        {
+            emaOut.push_back(ema / 65536.0);
+            trackedOut.push_back(predictor.position() / 4294967296.0);
+        }
+    }
+    double emaNoise = noise(emaOut);
+    TEST_ASSERT_FLOAT_WITHIN(0.2 * emaNoise, emaNoise, noise(trackedOut));
+}
+
+// A Q10.16 minta tort resze (CIC, igazitas, korrekcio) a becslesig eljut
+void test_fraction_reaches_tracker()
+{
+    AxisPredictor predictor;
+    const uint32_t sampleQ16 = (500UL << 16) + 0x8000; // 500.5
+    for (uint16_t i = 0; i < 100; ++i)
+    {
+        predictor.updateQ16(sampleQ16);
+    }
+    TEST_ASSERT_UINT32_WITHIN(1, sampleQ16, predictor.predict(0));
+}
+
+void test_lag_on_strokes()
+{
+    AxisRun run = runTrace(CHANNEL_RUDDER, "raw2");
+    double emaLag = lagUs(run.ema, run.reference);
+    double predictedLag = lagUs(run.predicted, run.reference);
+    // Az EMA idoallandoja 256 frame = 128 ms; a prediktort a fordulokban a korlat fogja vissza
+    TEST_ASSERT_GREATER_THAN_FLOAT(80000.0, emaLag);
+    TEST_ASSERT_LESS_THAN_FLOAT(15000.0, fabs(predictedLag));
+    TEST_ASSERT_LESS_THAN_FLOAT(emaLag / 5.0, fabs(predictedLag));
+}
+
+void test_lag_on_smooth_motion()
+{
+    AxisRun run = runTrace(CHANNEL_HAND_WHEEL, "raw5");
+    double emaLag = lagUs(run.ema, run.reference);
+    double predictedLag = lagUs(run.predicted, run.reference);
+    TEST_ASSERT_GREATER_THAN_FLOAT(80000.0, emaLag);
+    TEST_ASSERT_LESS_THAN_FLOAT(5000.0, fabs(predictedLag));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_noise_at_rest);
+    RUN_TEST(test_white_noise_matches_ema);
+    RUN_TEST(test_fraction_reaches_tracker);
+    RUN_TEST(test_lag_on_strokes);
+    RUN_TEST(test_lag_on_smooth_motion);
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+//
+// RunningMedian against copy-and-sort on every sample, for every window
+// size, while the window fills and after it slides; the input crosses the
+// coarse bin edges and hits both ends of the ADC range.
+//   pio test -e native -f test_running_median
+//
+#include <unity.h>
+#include <RunningMedian.h>
+#include <algorithm>
+
+static uint32_t rng = 1;
+
+static uint16_t nextSample(uint16_t i)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    if ((rng & 0x3F) == 0)
+    {
+        return (rng & 0x40) ? MEDIAN_DOMAIN - 1 : 0; // tuske
+    }
+    // Lassu rampa kis zajjal: sok azonos ertek egy binen belul, es binhatar atlepesek
+    return (300 + (i >> 2) + (rng % 5)) % MEDIAN_DOMAIN;
+}
+
+static uint16_t sortedMedian(const uint16_t *window, uint8_t count)
+{
+    uint16_t sorted[MEDIAN_MAX_WINDOW];
+    std::copy(window, window + count, sorted);
+    std::sort(sorted, sorted + count);
+    return sorted[(count - 1) / 2];
+}
+
+void setUp()
+{
+    rng = 0x12345678u;
+}
+
+void tearDown()
+{
+}
+
+void test_matches_sort_for_every_window()
+{
+    RunningMedian median;
+    for (uint8_t window = 1; window <= MEDIAN_MAX_WINDOW; ++window)
+    {
+        median.setWindow(window);
+        uint16_t ring[MEDIAN_MAX_WINDOW];
+        uint8_t count = 0;
+        uint8_t head = 0;
+        for (uint16_t i = 0; i < 2000; ++i)
+        {
+            uint16_t value = nextSample(i);
+            ring[head] = value;
+            head = (head + 1) % window;
+            if (count < window)
+            {
+                count++;
+            }
+            TEST_ASSERT_EQUAL_UINT16(sortedMedian(ring, count), median(value));
+        }
+    }
+}
+
+void test_window_limits_and_clamp()
+{
+    RunningMedian median;
+    median.setWindow(0);
+    TEST_ASSERT_EQUAL_UINT8(1, median.getWindow());
+    median.setWindow(MEDIAN_MAX_WINDOW + 10);
+    TEST_ASSERT_EQUAL_UINT8(MEDIAN_MAX_WINDOW, median.getWindow());
+
+    // A tartomanyon kivuli ertek a legnagyobbra korlatozva
+    median.setWindow(1);
+    TEST_ASSERT_EQUAL_UINT16(MEDIAN_DOMAIN - 1, median(5000));
+}
+
+void test_reset_forgets_samples()
+{
+    RunningMedian median;
+    median.setWindow(5);
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        median(1000);
+    }
+    median.reset();
+    TEST_ASSERT_EQUAL_UINT16(10, median(10));
+    TEST_ASSERT_EQUAL_UINT16(10, median(20)); // also median
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_sort_for_every_window);
+    RUN_TEST(test_window_limits_and_clamp);
+    RUN_TEST(test_reset_forgets_samples);
+    return UNITY_END();
+}
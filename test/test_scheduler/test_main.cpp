@@ -0,0 +1,272 @@
+//
+// Scheduler on a fake clock: priority order, tie-breaking, overrun and
+// skip counters, 32-bit micros wrap and the idle hook.
+//   pio test -e native -f test_scheduler
+//
+#include <unity.h>
+#include <Scheduler.h>
+
+static uint32_t fakeNowUs = 0;
+static uint32_t lastWakeUs = 0;
+static uint32_t idleCalls = 0;
+
+static uint32_t fakeClock()
+{
+    return fakeNowUs;
+}
+
+// Alvas helyett az ora ugrik a kert idopontra
+static void fakeIdle(uint32_t wakeAtUs)
+{
+    idleCalls++;
+    lastWakeUs = wakeAtUs;
+    fakeNowUs = wakeAtUs;
+}
+
+// Futasi naplo: a task context-je a sajat leiroja
+struct Probe
+{
+    uint8_t id;
+    uint32_t costUs; // ennyit halad az ora futas kozben
+};
+
+static uint8_t runLog[16];
+static uint8_t runCount = 0;
+
+static void probeTask(void *context)
+{
+    Probe *probe = static_cast<Probe *>(context);
+    if (runCount < sizeof(runLog))
+    {
+        runLog[runCount] = probe->id;
+    }
+    runCount++;
+    fakeNowUs += probe->costUs;
+}
+
+void setUp()
+{
+    fakeNowUs = 0;
+    lastWakeUs = 0;
+    idleCalls = 0;
+    runCount = 0;
+    memset(runLog, 0xFF, sizeof(runLog));
+}
+
+void tearDown()
+{
+}
+
+void test_ready_tasks_run_in_priority_order()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe low = {0, 0};
+    Probe high = {1, 0};
+    Probe middle = {2, 0};
+    scheduler.addTask("low", probeTask, &low, 1000, 2);
+    scheduler.addTask("high", probeTask, &high, 1000, 0);
+    scheduler.addTask("middle", probeTask, &middle, 1000, 1);
+
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_FALSE(scheduler.runOnce()); // mindegyik a kovetkezo periodusra var
+
+    TEST_ASSERT_EQUAL_UINT8(1, runLog[0]);
+    TEST_ASSERT_EQUAL_UINT8(2, runLog[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, runLog[2]);
+}
+
+void test_equal_priority_runs_earliest_release_first()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe first = {0, 0};
+    Probe second = {1, 0};
+    int8_t a = scheduler.addTask("a", probeTask, &first, 1000, 1);
+    scheduler.addTask("b", probeTask, &second, 1000, 1);
+
+    // 'a' kiadasa kesobbre kerul, igy a kisebb index ellenere 'b' a korabbi
+    scheduler.setEnabled(a, false);
+    fakeNowUs = 100;
+    scheduler.setEnabled(a, true);
+    fakeNowUs = 200;
+
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT8(1, runLog[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, runLog[1]);
+}
+
+void test_higher_priority_wins_over_earlier_release()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe early = {0, 0};
+    Probe urgent = {1, 0};
+    scheduler.addTask("early", probeTask, &early, 1000, 3);
+    fakeNowUs = 400;
+    scheduler.addTask("urgent", probeTask, &urgent, 1000, 0);
+
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT8(1, runLog[0]);
+}
+
+void test_overrun_and_skipped_periods_are_counted()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe slow = {0, 2500}; // 2.5 periodus
+    int8_t id = scheduler.addTask("slow", probeTask, &slow, 1000, 0);
+
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    const TaskStats &stats = scheduler.task(id).stats;
+    TEST_ASSERT_EQUAL_UINT32(1, stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.overruns);
+    // 2500-kor vegzett: az 1000-es es 2000-es kiadas elmaradt, a kovetkezo 3000
+    TEST_ASSERT_EQUAL_UINT32(2, stats.skipped);
+    TEST_ASSERT_EQUAL_UINT32(2500, stats.maxRunUs);
+    TEST_ASSERT_EQUAL_UINT32(3000, scheduler.task(id).releaseUs);
+
+    // Idoben vegzo futas: nincs uj overrun es kimaradas
+    slow.costUs = 100;
+    fakeNowUs = 3000;
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT32(1, stats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.skipped);
+    TEST_ASSERT_EQUAL_UINT32(4000, scheduler.task(id).releaseUs);
+}
+
+void test_explicit_deadline_overrun()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe task = {0, 300};
+    int8_t id = scheduler.addTask("deadline", probeTask, &task, 1000, 0, 200);
+
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.task(id).stats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.task(id).stats.skipped);
+}
+
+void test_micros_wrap()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe task = {0, 0};
+    fakeNowUs = 0xFFFFFF00UL;
+    int8_t id = scheduler.addTask("wrap", probeTask, &task, 0x200, 0);
+
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_HEX32(0x00000100UL, scheduler.task(id).releaseUs);
+
+    // Szamszeruen 0x100 < most, de az atfordulas utan van: meg nem kesz
+    fakeNowUs = 0xFFFFFFF0UL;
+    TEST_ASSERT_FALSE(scheduler.runOnce());
+    uint32_t next = 0;
+    TEST_ASSERT_TRUE(scheduler.nextReleaseUs(next));
+    TEST_ASSERT_EQUAL_HEX32(0x00000100UL, next);
+
+    // run(): alvas az atfordulas utani kiadasig, majd futas
+    scheduler.run();
+    TEST_ASSERT_EQUAL_UINT32(1, idleCalls);
+    TEST_ASSERT_EQUAL_HEX32(0x00000100UL, lastWakeUs);
+    scheduler.run();
+    TEST_ASSERT_EQUAL_UINT32(2, scheduler.task(id).stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.task(id).stats.skipped);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.task(id).stats.overruns);
+}
+
+void test_tie_break_across_wrap()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe beforeWrap = {0, 0};
+    Probe afterWrap = {1, 0};
+    fakeNowUs = 0x10;
+    scheduler.addTask("after", probeTask, &afterWrap, 1000, 1);
+    // A masodik task az atfordulas elott lett kiadva: ez a korabbi
+    int8_t id = scheduler.addTask("before", probeTask, &beforeWrap, 1000, 1);
+    scheduler.setEnabled(id, false);
+    fakeNowUs = 0xFFFFFFF0UL;
+    scheduler.setEnabled(id, true);
+    fakeNowUs = 0x20;
+
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT8(0, runLog[0]);
+}
+
+void test_skip_count_across_wrap()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe slow = {0, 0x300};
+    fakeNowUs = 0xFFFFFF00UL;
+    int8_t id = scheduler.addTask("slow", probeTask, &slow, 0x100, 0);
+
+    // 0xFFFFFF00 + 0x300 = 0x200 az atfordulas utan: 0x000, 0x100 es 0x200 kiadas kimarad
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.task(id).stats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(3, scheduler.task(id).stats.skipped);
+    TEST_ASSERT_EQUAL_HEX32(0x00000300UL, scheduler.task(id).releaseUs);
+    TEST_ASSERT_EQUAL_UINT32(0x300, scheduler.task(id).stats.maxRunUs);
+}
+
+void test_idle_sleeps_until_next_release()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe fast = {0, 10};
+    Probe slow = {1, 10};
+    scheduler.addTask("fast", probeTask, &fast, 500, 0);
+    scheduler.addTask("slow", probeTask, &slow, 2000, 1);
+
+    // 0: mindketto; utana 500-ig alszik
+    scheduler.run();
+    scheduler.run();
+    scheduler.run();
+    TEST_ASSERT_EQUAL_UINT32(1, idleCalls);
+    TEST_ASSERT_EQUAL_UINT32(500, lastWakeUs);
+    TEST_ASSERT_EQUAL_UINT8(2, runCount);
+}
+
+void test_disabled_and_one_shot_tasks()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe periodic = {0, 0};
+    Probe oneShot = {1, 0};
+    int8_t p = scheduler.addTask("periodic", probeTask, &periodic, 1000, 1);
+    int8_t o = scheduler.addTask("oneshot", probeTask, &oneShot, 0, 0);
+    scheduler.setEnabled(p, false);
+
+    // Egyszeri task trigger nelkul nem fut, letiltott task sem
+    TEST_ASSERT_FALSE(scheduler.runOnce());
+    uint32_t next;
+    TEST_ASSERT_FALSE(scheduler.nextReleaseUs(next));
+
+    scheduler.trigger(o);
+    TEST_ASSERT_TRUE(scheduler.runOnce());
+    TEST_ASSERT_FALSE(scheduler.runOnce());
+    TEST_ASSERT_EQUAL_UINT8(1, runLog[0]);
+}
+
+void test_task_table_limit()
+{
+    Scheduler scheduler(fakeClock, fakeIdle);
+    Probe probe = {0, 0};
+    for (uint8_t i = 0; i < SCHEDULER_MAX_TASKS; ++i)
+    {
+        TEST_ASSERT_EQUAL_INT8(i, scheduler.addTask("task", probeTask, &probe, 1000, i));
+    }
+    TEST_ASSERT_EQUAL_INT8(-1, scheduler.addTask("extra", probeTask, &probe, 1000, 0));
+    TEST_ASSERT_EQUAL_INT8(-1, scheduler.addTask("null", nullptr, nullptr, 1000, 0));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ready_tasks_run_in_priority_order);
+    RUN_TEST(test_equal_priority_runs_earliest_release_first);
+    RUN_TEST(test_higher_priority_wins_over_earlier_release);
+    RUN_TEST(test_overrun_and_skipped_periods_are_counted);
+    RUN_TEST(test_explicit_deadline_overrun);
+    RUN_TEST(test_micros_wrap);
+    RUN_TEST(test_tie_break_across_wrap);
+    RUN_TEST(test_skip_count_across_wrap);
+    RUN_TEST(test_idle_sleeps_until_next_release);
+    RUN_TEST(test_disabled_and_one_shot_tasks);
+    RUN_TEST(test_task_table_limit);
+    return UNITY_END();
+}
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Decode the PicoJoystick binary sample stream (SampleStream) into CSV.
+
+The firmware sends COBS-framed packets, 0x00 terminated, once streaming is
+switched on with 'T' on the serial console. Read straight from the port:
+
+    python3 tools/stream_decode.py --port /dev/ttyACM0 -o samples.csv
+
+or decode a capture file (e.g. from `cat /dev/ttyACM0 > capture.bin`):
+
+    python3 tools/stream_decode.py capture.bin > samples.csv
+
+CSV goes to stdout by default, so it can be piped into a plotting tool.
+Lost packets (host too slow, reported by the device) and corrupt frames are
+summarised on stderr at the end.
+"""
+
+import argparse
+import struct
+import sys
+
+CHANNELS = 8
+PACKET_SAMPLE = 0x01
+# type, channels, sequence, timestamp_us, dropped, raw[8], filtered[8], mapped[8], crc
+PACKET_FORMAT = "<BBHIH%dH%dH%dhH" % (CHANNELS, CHANNELS, CHANNELS)
+PACKET_LENGTH = struct.calcsize(PACKET_FORMAT)
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame) + 1:
+            raise ValueError("bad COBS frame")
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def frames(stream):
+    """Yield the raw bytes between 0x00 delimiters."""
+    buffer = bytearray()
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            return
+        buffer += chunk
+        while True:
+            end = buffer.find(b"\x00")
+            if end < 0:
+                break
+            yield bytes(buffer[:end])
+            del buffer[:end + 1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", help="capture file (default: stdin)")
+    parser.add_argument("--port", help="serial port to open instead of a file")
+    parser.add_argument("--no-enable", action="store_true",
+                        help="do not send 'T' to switch streaming on")
+    parser.add_argument("-o", "--output", help="CSV file (default: stdout)")
+    args = parser.parse_args()
+
+    if args.port:
+        import serial  # pyserial
+        source = serial.Serial(args.port, timeout=1)
+        if not args.no_enable:
+            source.write(b"T")
+    elif args.input:
+        source = open(args.input, "rb")
+    else:
+        source = sys.stdin.buffer
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    header = ["sequence", "timestamp_us", "dropped"]
+    header += ["raw%d" % ch for ch in range(CHANNELS)]
+    header += ["filtered%d" % ch for ch in range(CHANNELS)]
+    header += ["mapped%d" % ch for ch in range(CHANNELS)]
+    out.write(",".join(header) + "\n")
+
+    packets = corrupt = dropped = lost = 0
+    last_sequence = None
+    try:
+        for frame in frames(source):
+            try:
+                payload = cobs_decode(frame)
+            except ValueError:
+                corrupt += 1
+                continue
+            if len(payload) != PACKET_LENGTH or payload[0] != PACKET_SAMPLE:
+                corrupt += 1  # text log lines or a partial first frame
+                continue
+            fields = struct.unpack(PACKET_FORMAT, payload)
+            if crc16_ccitt(payload[:-2]) != fields[-1]:
+                corrupt += 1
+                continue
+
+            sequence, timestamp, drop = fields[2], fields[3], fields[4]
+            if last_sequence is not None:
+                gap = (sequence - last_sequence - 1) & 0xFFFF
+                lost += gap
+            last_sequence = sequence
+            dropped += drop
+            packets += 1
+            out.write(",".join(str(v) for v in (sequence, timestamp, drop) + fields[5:-1]) + "\n")
+    except KeyboardInterrupt:
+        pass
+
+    sys.stderr.write("packets=%d dropped_on_device=%d sequence_gaps=%d corrupt=%d\n"
+                     % (packets, dropped, lost, corrupt))
+
+
+if __name__ == "__main__":
+    main()